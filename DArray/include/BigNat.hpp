@@ -0,0 +1,128 @@
+#ifndef BIGNAT_HPP
+#define BIGNAT_HPP
+
+#include <compare>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Натуральное число произвольной длины. Пока значение помещается в машинное слово,
+// оно хранится в small; при переполнении число переходит в массив 32-битных разрядов.
+class BigNat {
+    std::uint64_t small; // значение в малом режиме
+    std::vector<std::uint32_t> limbs; // разряды по основанию 2^32, младшие первыми; пусто в малом режиме
+
+    using Limbs = std::vector<std::uint32_t>;
+
+    static constexpr std::size_t karatsubaThreshold = 32; // размер в разрядах, начиная с которого выгоднее Карацуба
+
+    static BigNat fromLimbs(Limbs &&digits);
+
+    [[nodiscard]] Limbs toLimbs() const;
+
+    static BigNat addSlow(const BigNat &left, const BigNat &right);
+
+    static BigNat subtractSlow(const BigNat &left, const BigNat &right);
+
+    static BigNat multiplySlow(const BigNat &left, const BigNat &right);
+
+    static void divideSlow(const BigNat &left, const BigNat &right, BigNat *quotient, BigNat *remainder);
+
+    static std::strong_ordering compareSlow(const BigNat &left, const BigNat &right);
+
+    static Limbs multiplyLimbs(const std::uint32_t *left, std::size_t leftSize,
+                               const std::uint32_t *right, std::size_t rightSize);
+
+    [[noreturn]] static void throwNegative();
+
+    [[noreturn]] static void throwDivisionByZero();
+
+public:
+    BigNat() : small(0) {}
+
+    BigNat(std::uint64_t value) : small(value) {}
+
+    static BigNat fromWords(std::uint64_t low, std::uint64_t high); // high * 2^64 + low
+
+    static BigNat parse(std::string_view text); // десятичная запись, допускаются пробелы по краям
+
+    [[nodiscard]] bool isSmall() const { return limbs.empty(); }
+
+    [[nodiscard]] bool isZero() const { return limbs.empty() && small == 0; }
+
+    [[nodiscard]] std::uint64_t smallValue() const { return small; } // имеет смысл только в малом режиме
+
+    [[nodiscard]] unsigned toUnsigned() const; // бросает std::overflow_error, если значение не помещается
+
+    [[nodiscard]] std::string toString() const;
+
+    friend BigNat operator+(const BigNat &left, const BigNat &right) {
+        if (std::uint64_t result; left.isSmall() && right.isSmall() &&
+                                  !__builtin_add_overflow(left.small, right.small, &result))
+            return {result};
+
+        return addSlow(left, right);
+    }
+
+    friend BigNat operator-(const BigNat &left, const BigNat &right) {
+        if (left.isSmall() && right.isSmall()) {
+            if (left.small < right.small)
+                throwNegative();
+
+            return {left.small - right.small};
+        }
+
+        return subtractSlow(left, right);
+    }
+
+    friend BigNat operator*(const BigNat &left, const BigNat &right) {
+        if (std::uint64_t result; left.isSmall() && right.isSmall() &&
+                                  !__builtin_mul_overflow(left.small, right.small, &result))
+            return {result};
+
+        return multiplySlow(left, right);
+    }
+
+    friend BigNat operator/(const BigNat &left, const BigNat &right) {
+        if (right.isZero())
+            throwDivisionByZero();
+
+        if (left.isSmall() && right.isSmall())
+            return {left.small / right.small};
+
+        BigNat quotient;
+        divideSlow(left, right, &quotient, nullptr);
+
+        return quotient;
+    }
+
+    friend BigNat operator%(const BigNat &left, const BigNat &right) {
+        if (right.isZero())
+            throwDivisionByZero();
+
+        if (left.isSmall() && right.isSmall())
+            return {left.small % right.small};
+
+        BigNat remainder;
+        divideSlow(left, right, nullptr, &remainder);
+
+        return remainder;
+    }
+
+    friend bool operator==(const BigNat &left, const BigNat &right) {
+        return left.small == right.small && left.limbs == right.limbs;
+    }
+
+    friend std::strong_ordering operator<=>(const BigNat &left, const BigNat &right) {
+        if (left.isSmall() && right.isSmall())
+            return left.small <=> right.small;
+
+        return compareSlow(left, right);
+    }
+
+    friend std::ostream &operator<<(std::ostream &os, const BigNat &number);
+};
+
+#endif //BIGNAT_HPP
@@ -0,0 +1,92 @@
+#ifndef CHUNKSTORE_HPP
+#define CHUNKSTORE_HPP
+
+#include <cstddef>
+#include <cstdio>
+#include <list>
+#include <mutex>
+#include <vector>
+
+// Хранилище блоков элементов DArray. Блоки, не поместившиеся в бюджет памяти,
+// вытесняются во временный файл и подгружаются обратно при обращении.
+// Хранилище одно на процесс (все методы статические), обращения к нему защищены мьютексом: разные DArray
+// и интерпретаторы могут работать в разных потоках. Один DArray, как и стандартные контейнеры,
+// нельзя одновременно менять из нескольких потоков.
+class ChunkStore {
+public:
+    static constexpr unsigned chunkSize = 1024; // Количество элементов в блоке
+    static constexpr std::size_t chunkBytes = chunkSize * sizeof(int); // Размер блока в байтах
+    static constexpr std::size_t defaultMemoryBudget = std::size_t{512} << 20; // Бюджет по умолчанию
+
+    using Handle = unsigned;
+
+    // Закрепляет блок в памяти на время своего существования
+    class Pin {
+        Handle handle;
+        int *values;
+
+    public:
+        Pin(Handle handle, bool forWrite);
+
+        Pin(const Pin &) = delete;
+
+        Pin &operator=(const Pin &) = delete;
+
+        ~Pin();
+
+        [[nodiscard]] int *data() const { return values; }
+
+        int &operator[](unsigned index) const { return values[index]; }
+    };
+
+    static Handle allocate(); // новый блок, заполненный нулями
+
+    static void release(Handle handle);
+
+    // Элемент блока без закрепления: другой поток может вытеснить блок сразу после обращения,
+    // поэтому указатель на данные наружу не выдаётся
+    [[nodiscard]] static int read(Handle handle, unsigned index);
+
+    static void write(Handle handle, unsigned index, int value);
+
+    static void setMemoryBudget(std::size_t bytes);
+
+    [[nodiscard]] static std::size_t getMemoryBudget();
+
+    [[nodiscard]] static std::size_t getResidentBytes();
+
+private:
+    struct Chunk {
+        int *data = nullptr; // nullptr, если блок вытеснен
+        long slot = -1; // Номер слота во временном файле
+        unsigned pins = 0; // Количество закреплений
+        bool dirty = true; // Содержимое отличается от копии в файле
+        std::list<Handle>::iterator lruPosition;
+    };
+
+    std::vector<Chunk> chunks;
+    std::vector<Handle> freeHandles;
+    std::list<Handle> lru; // Резидентные блоки, в начале самые холодные
+    std::vector<long> freeSlots;
+    long nextSlot = 0;
+    std::FILE *spillFile = nullptr;
+    std::size_t memoryBudget = defaultMemoryBudget;
+    std::size_t residentBytes = 0;
+    std::mutex mutex; // Закрытые методы вызываются под ним
+
+    ChunkStore() = default;
+
+    ~ChunkStore();
+
+    static ChunkStore &instance();
+
+    int *makeResident(Handle handle, bool forWrite);
+
+    void evictUntilFits();
+
+    void spill(Handle handle);
+
+    void touch(Handle handle);
+};
+
+#endif //CHUNKSTORE_HPP
@@ -4,28 +4,34 @@
 #include <iosfwd>
 #include <vector>
 
-struct Node {
-    int value; // Значение, хранящееся в узле
-    Node *next; // Указатель на следующий узел
-    Node *prev; // Указатель на предыдущий узел
-
-    explicit Node(int val) : value(val), next(nullptr), prev(nullptr) {}
-};
+#include "BigNat.hpp"
+#include "ChunkStore.hpp"
 
 class DArray {
     unsigned size; // Текущий размер массива
-    Node *head; // Указатель на первый узел
-    Node *tail; // Указатель на последний узел
+    std::vector<ChunkStore::Handle> chunks; // Блоки элементов, лишние вытесняются на диск
 
     static void checkVectorSize(const DArray &left, const DArray &right);
 
     static void checkDivisionByZero(const DArray &right);
 
+    // Копирует count элементов, проходя по блокам обоих массивов
+    static void copyElements(const DArray &source, unsigned sourcePos, DArray &destination, unsigned destinationPos,
+                             unsigned count);
+
+    [[nodiscard]] unsigned chunkLength(std::size_t chunk) const; // количество занятых элементов в блоке
+
+    void resize(unsigned newSize);
+
     void copyFrom(const DArray &other);
 
     void clear();
 
-    DArray &applyBinaryAssignment(const DArray &right, void (*op)(int &, int));
+    [[nodiscard]] static unsigned sortRunLength(); // серия, которую sort() упорядочивает в памяти целиком
+
+    void sortRun(unsigned first, unsigned count); // first кратно размеру блока
+
+    void mergeRuns(unsigned runLength); // слияние упорядоченных серий длины runLength
 
     DArray applyBinaryOperation(const DArray &right, int (*op)(int, int)) const;
 
@@ -34,10 +40,16 @@ public:
 
     DArray(const DArray &other);
 
-    explicit DArray(const std::vector<unsigned> &vec);
+    DArray(DArray &&other) noexcept;
+
+    explicit DArray(const std::vector<unsigned> &vec); // std::overflow_error, если элемент больше INT_MAX
+
+    DArray(const int *values, unsigned count);
 
     ~DArray();
 
+    // Поэлементные операции. Элементы — натуральные числа не больше INT_MAX: переполнение бросает
+    // std::overflow_error, отрицательная разность — std::domain_error, как у BigNat
     DArray operator+(const DArray &right) const;
 
     DArray &operator+=(const DArray &right);
@@ -58,14 +70,18 @@ public:
 
     DArray &operator%=(const DArray &right);
 
-    [[nodiscard]] int dot(const DArray &right) const; // скалярное произведение
+    [[nodiscard]] BigNat dot(const DArray &right) const; // скалярное произведение, точное
 
-    int &operator[](unsigned index);
+    // Элемент возвращается копией: ссылка указывала бы в незакреплённый блок, который следующее
+    // обращение к хранилищу может вытеснить (например, в a[i] = a[j])
+    [[nodiscard]] int operator[](unsigned index) const;
 
-    const int &operator[](unsigned index) const;
+    void set(unsigned index, int value);
 
     DArray &operator=(const DArray &right);
 
+    DArray &operator=(DArray &&right) noexcept;
+
     bool operator==(const DArray &right) const;
 
     bool operator!=(const DArray &right) const;
@@ -83,12 +99,13 @@ public:
     DArray &operator>>=(unsigned shift);
 
     class Iterator {
-        Node *current;
+        const DArray *array; // nullptr у итератора конца
+        unsigned index;
 
     public:
-        explicit Iterator(Node *node);
+        Iterator(const DArray *array, unsigned index);
 
-        int &operator*() const;
+        int operator*() const; // копия элемента, как у operator[]
 
         Iterator &operator++(); // Префиксный инкремент
         Iterator operator++(int); // Постфиксный инкремент
@@ -112,6 +129,18 @@ public:
     void push_back(int value);
 
     [[nodiscard]] unsigned getSize() const;
+
+    void copyTo(int *destination) const; // копирует все элементы в непрерывный буфер
+
+    void sort(); // по возрастанию, параллельная поразрядная сортировка в пределах бюджета памяти
+
+    [[nodiscard]] unsigned find(int value) const; // двоичный поиск в отсортированном массиве, getSize() если нет
+
+    void unique(); // удаляет подряд идущие повторы, в отсортированном массиве — все
+
+    [[nodiscard]] DArray gather(const DArray &indices) const; // result[i] = (*this)[indices[i]]
+
+    void scatter(const DArray &indices, const DArray &values); // (*this)[indices[i]] = values[i]
 };
 
 #endif //DARRAY_HPP
@@ -0,0 +1,61 @@
+#ifndef MATRIX_HPP
+#define MATRIX_HPP
+
+#include <iosfwd>
+#include <vector>
+
+#include "DArray.hpp"
+
+// Матрица целых чисел, хранящаяся построчно в непрерывном буфере. Элементы лежат в std::vector, а не
+// в DArray: блочному умножению нужны непрерывные строки по указателю, а блоки DArray по 1024 элемента
+// могут быть вытеснены на диск. С DArray матрица обменивается при mload, mrow, mcol и умножении на вектор.
+// Произведения точные: элемент, не помещающийся в int, — ошибка std::overflow_error
+class Matrix {
+    unsigned rows; // Количество строк
+    unsigned columns; // Количество столбцов
+    std::vector<int> values; // Элементы строка за строкой
+
+    static constexpr unsigned blockRows = 32; // Размеры блока для умножения и транспонирования,
+    static constexpr unsigned blockDepth = 128; // подобранные так, чтобы блоки операндов
+    static constexpr unsigned blockColumns = 256; // помещались в кэш первого и второго уровня
+
+    template<typename Sum>
+    void multiplyBlocked(const Matrix &right, Matrix &result) const; // суммы в типе Sum
+
+public:
+    Matrix();
+
+    Matrix(unsigned rows, unsigned columns);
+
+    Matrix(const DArray &elements, unsigned rows); // элементы вектора, разбитые на rows строк
+
+    [[nodiscard]] unsigned getRows() const;
+
+    [[nodiscard]] unsigned getColumns() const;
+
+    int &operator()(unsigned row, unsigned column);
+
+    const int &operator()(unsigned row, unsigned column) const;
+
+    Matrix operator*(const Matrix &right) const;
+
+    DArray operator*(const DArray &vector) const;
+
+    bool operator==(const Matrix &right) const;
+
+    bool operator!=(const Matrix &right) const;
+
+    [[nodiscard]] Matrix transpose() const;
+
+    [[nodiscard]] DArray row(unsigned index) const;
+
+    [[nodiscard]] DArray column(unsigned index) const;
+
+    [[nodiscard]] Matrix rowSlice(unsigned first, unsigned count) const; // строки [first, first + count)
+
+    [[nodiscard]] Matrix columnSlice(unsigned first, unsigned count) const; // столбцы [first, first + count)
+
+    friend std::ostream &operator<<(std::ostream &os, const Matrix &matrix);
+};
+
+#endif //MATRIX_HPP
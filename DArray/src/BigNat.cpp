@@ -0,0 +1,364 @@
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <climits>
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/BigNat.hpp"
+
+namespace {
+    using Limb = std::uint32_t;
+    using Limbs = std::vector<Limb>;
+
+    constexpr std::uint64_t limbBase = std::uint64_t{1} << 32;
+    constexpr Limb decimalChunk = 1000000000; // 10^9 — наибольшая степень десяти в одном разряде
+    constexpr std::size_t decimalChunkDigits = 9;
+
+    Limb lowHalf(std::uint64_t value) { return static_cast<Limb>(value & 0xFFFFFFFFu); }
+
+    Limb highHalf(std::uint64_t value) { return static_cast<Limb>(value >> 32); }
+
+    void trim(Limbs &digits) {
+        while (!digits.empty() && digits.back() == 0)
+            digits.pop_back();
+    }
+
+    // digits += addend * 2^(32 * offset)
+    void addShifted(Limbs &digits, const Limb *addend, std::size_t addendSize, std::size_t offset) {
+        if (digits.size() < offset + addendSize)
+            digits.resize(offset + addendSize, 0);
+
+        std::uint64_t carry = 0;
+        for (std::size_t i = 0; i < addendSize; ++i) {
+            const std::uint64_t sum = std::uint64_t{digits[offset + i]} + addend[i] + carry;
+            digits[offset + i] = lowHalf(sum);
+            carry = sum >> 32;
+        }
+
+        for (std::size_t i = offset + addendSize; carry != 0; ++i) {
+            if (i == digits.size())
+                digits.push_back(0);
+            const std::uint64_t sum = std::uint64_t{digits[i]} + carry;
+            digits[i] = lowHalf(sum);
+            carry = sum >> 32;
+        }
+    }
+
+    // digits -= subtrahend, при условии digits >= subtrahend
+    void subtractInPlace(Limbs &digits, const Limb *subtrahend, std::size_t subtrahendSize) {
+        std::uint64_t borrow = 0;
+        for (std::size_t i = 0; i < digits.size() && (i < subtrahendSize || borrow != 0); ++i) {
+            const std::uint64_t difference = std::uint64_t{digits[i]} - (i < subtrahendSize ? subtrahend[i] : 0) - borrow;
+            digits[i] = lowHalf(difference);
+            borrow = highHalf(difference) != 0 ? 1 : 0;
+        }
+
+        trim(digits);
+    }
+
+    // digits = digits * factor + addend
+    void multiplyAddSmall(Limbs &digits, Limb factor, Limb addend) {
+        std::uint64_t carry = addend;
+        for (Limb &digit: digits) {
+            const std::uint64_t product = std::uint64_t{digit} * factor + carry;
+            digit = lowHalf(product);
+            carry = product >> 32;
+        }
+
+        if (carry != 0)
+            digits.push_back(lowHalf(carry));
+    }
+
+    // digits /= divisor, возвращает остаток
+    Limb divideSmall(Limbs &digits, Limb divisor) {
+        std::uint64_t remainder = 0;
+        for (std::size_t i = digits.size(); i-- > 0;) {
+            const std::uint64_t current = (remainder << 32) | digits[i];
+            digits[i] = lowHalf(current / divisor);
+            remainder = current % divisor;
+        }
+
+        trim(digits);
+
+        return lowHalf(remainder);
+    }
+
+    Limbs multiplySchoolbook(const Limb *left, std::size_t leftSize, const Limb *right, std::size_t rightSize) {
+        Limbs result(leftSize + rightSize, 0);
+        for (std::size_t i = 0; i < leftSize; ++i) {
+            std::uint64_t carry = 0;
+            for (std::size_t j = 0; j < rightSize; ++j) {
+                const std::uint64_t product = std::uint64_t{left[i]} * right[j] + result[i + j] + carry;
+                result[i + j] = lowHalf(product);
+                carry = product >> 32;
+            }
+            result[i + rightSize] = lowHalf(carry);
+        }
+
+        trim(result);
+
+        return result;
+    }
+}
+
+BigNat BigNat::fromLimbs(Limbs &&digits) {
+    trim(digits);
+
+    BigNat result;
+    if (digits.size() <= 2) {
+        for (std::size_t i = digits.size(); i-- > 0;)
+            result.small = (result.small << 32) | digits[i];
+    } else
+        result.limbs = std::move(digits);
+
+    return result;
+}
+
+BigNat::Limbs BigNat::toLimbs() const {
+    if (!isSmall())
+        return limbs;
+
+    Limbs digits{lowHalf(small), highHalf(small)};
+    trim(digits);
+
+    return digits;
+}
+
+BigNat BigNat::addSlow(const BigNat &left, const BigNat &right) {
+    Limbs sum = left.toLimbs();
+    const Limbs addend = right.toLimbs();
+    addShifted(sum, addend.data(), addend.size(), 0);
+
+    return fromLimbs(std::move(sum));
+}
+
+BigNat BigNat::subtractSlow(const BigNat &left, const BigNat &right) {
+    if (compareSlow(left, right) < 0)
+        throwNegative();
+
+    Limbs difference = left.toLimbs();
+    const Limbs subtrahend = right.toLimbs();
+    subtractInPlace(difference, subtrahend.data(), subtrahend.size());
+
+    return fromLimbs(std::move(difference));
+}
+
+BigNat BigNat::multiplySlow(const BigNat &left, const BigNat &right) {
+    const Limbs leftDigits = left.toLimbs();
+    const Limbs rightDigits = right.toLimbs();
+
+    return fromLimbs(multiplyLimbs(leftDigits.data(), leftDigits.size(), rightDigits.data(), rightDigits.size()));
+}
+
+BigNat::Limbs BigNat::multiplyLimbs(const std::uint32_t *left, std::size_t leftSize,
+                                    const std::uint32_t *right, std::size_t rightSize) {
+    if (std::min(leftSize, rightSize) < karatsubaThreshold)
+        return multiplySchoolbook(left, leftSize, right, rightSize);
+
+    // left = left1 * B^half + left0, right = right1 * B^half + right0
+    const std::size_t half = std::min(leftSize, rightSize) / 2;
+
+    const Limbs low = multiplyLimbs(left, half, right, half);
+    const Limbs high = multiplyLimbs(left + half, leftSize - half, right + half, rightSize - half);
+
+    Limbs leftSum(left, left + half);
+    addShifted(leftSum, left + half, leftSize - half, 0);
+    Limbs rightSum(right, right + half);
+    addShifted(rightSum, right + half, rightSize - half, 0);
+    trim(leftSum);
+    trim(rightSum);
+
+    // (left0 + left1)(right0 + right1) - low - high = left0 * right1 + left1 * right0
+    Limbs middle = multiplyLimbs(leftSum.data(), leftSum.size(), rightSum.data(), rightSum.size());
+    subtractInPlace(middle, low.data(), low.size());
+    subtractInPlace(middle, high.data(), high.size());
+
+    Limbs result(leftSize + rightSize, 0);
+    addShifted(result, low.data(), low.size(), 0);
+    addShifted(result, middle.data(), middle.size(), half);
+    addShifted(result, high.data(), high.size(), 2 * half);
+    trim(result);
+
+    return result;
+}
+
+void BigNat::divideSlow(const BigNat &left, const BigNat &right, BigNat *quotient, BigNat *remainder) {
+    if (left < right) {
+        if (quotient) *quotient = BigNat();
+        if (remainder) *remainder = left;
+        return;
+    }
+
+    Limbs dividend = left.toLimbs();
+    const Limbs divisor = right.toLimbs();
+
+    if (divisor.size() == 1) {
+        const Limb rest = divideSmall(dividend, divisor[0]);
+        if (quotient) *quotient = fromLimbs(std::move(dividend));
+        if (remainder) *remainder = BigNat(rest);
+        return;
+    }
+
+    // Алгоритм D Кнута: нормализуем делитель так, чтобы старший бит старшего разряда был единицей
+    const std::size_t n = divisor.size();
+    const std::size_t m = dividend.size() - n;
+    const auto shift = static_cast<unsigned>(std::countl_zero(divisor.back()));
+
+    Limbs normalizedDivisor(n);
+    for (std::size_t i = n - 1; i > 0; --i)
+        normalizedDivisor[i] = shift ? (divisor[i] << shift) | (divisor[i - 1] >> (32 - shift)) : divisor[i];
+    normalizedDivisor[0] = divisor[0] << shift;
+
+    Limbs normalizedDividend(dividend.size() + 1);
+    normalizedDividend[dividend.size()] = shift ? dividend.back() >> (32 - shift) : 0;
+    for (std::size_t i = dividend.size() - 1; i > 0; --i)
+        normalizedDividend[i] = shift ? (dividend[i] << shift) | (dividend[i - 1] >> (32 - shift)) : dividend[i];
+    normalizedDividend[0] = dividend[0] << shift;
+
+    Limbs quotientDigits(m + 1, 0);
+    for (std::size_t j = m + 1; j-- > 0;) {
+        const std::uint64_t numerator = (std::uint64_t{normalizedDividend[j + n]} << 32) | normalizedDividend[j + n - 1];
+        std::uint64_t estimate = numerator / normalizedDivisor[n - 1];
+        std::uint64_t estimateRemainder = numerator % normalizedDivisor[n - 1];
+
+        while (estimate >= limbBase ||
+               estimate * normalizedDivisor[n - 2] > ((estimateRemainder << 32) | normalizedDividend[j + n - 2])) {
+            --estimate;
+            estimateRemainder += normalizedDivisor[n - 1];
+            if (estimateRemainder >= limbBase)
+                break;
+        }
+
+        // Вычитаем estimate * divisor из текущего окна делимого
+        std::int64_t borrow = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            const std::uint64_t product = estimate * normalizedDivisor[i];
+            const std::int64_t difference = static_cast<std::int64_t>(normalizedDividend[i + j]) - borrow -
+                                            static_cast<std::int64_t>(product & 0xFFFFFFFFu);
+            normalizedDividend[i + j] = static_cast<Limb>(static_cast<std::uint64_t>(difference) & 0xFFFFFFFFu);
+            borrow = static_cast<std::int64_t>(product >> 32) - (difference >> 32);
+        }
+        const std::int64_t top = static_cast<std::int64_t>(normalizedDividend[j + n]) - borrow;
+        normalizedDividend[j + n] = static_cast<Limb>(static_cast<std::uint64_t>(top) & 0xFFFFFFFFu);
+
+        // Оценка оказалась на единицу больше — возвращаем делитель обратно
+        if (top < 0) {
+            --estimate;
+            std::uint64_t carry = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                const std::uint64_t sum = std::uint64_t{normalizedDividend[i + j]} + normalizedDivisor[i] + carry;
+                normalizedDividend[i + j] = lowHalf(sum);
+                carry = sum >> 32;
+            }
+            normalizedDividend[j + n] = lowHalf(normalizedDividend[j + n] + carry);
+        }
+
+        quotientDigits[j] = lowHalf(estimate);
+    }
+
+    if (quotient)
+        *quotient = fromLimbs(std::move(quotientDigits));
+
+    if (remainder) {
+        Limbs rest(n);
+        for (std::size_t i = 0; i < n; ++i)
+            rest[i] = shift
+                          ? (normalizedDividend[i] >> shift) | (normalizedDividend[i + 1] << (32 - shift))
+                          : normalizedDividend[i];
+        *remainder = fromLimbs(std::move(rest));
+    }
+}
+
+std::strong_ordering BigNat::compareSlow(const BigNat &left, const BigNat &right) {
+    if (left.isSmall() != right.isSmall())
+        return left.isSmall() ? std::strong_ordering::less : std::strong_ordering::greater;
+
+    if (left.isSmall())
+        return left.small <=> right.small;
+
+    if (left.limbs.size() != right.limbs.size())
+        return left.limbs.size() <=> right.limbs.size();
+
+    for (std::size_t i = left.limbs.size(); i-- > 0;)
+        if (left.limbs[i] != right.limbs[i])
+            return left.limbs[i] <=> right.limbs[i];
+
+    return std::strong_ordering::equal;
+}
+
+void BigNat::throwNegative() {
+    throw std::domain_error("Результат вычитания не является натуральным числом");
+}
+
+void BigNat::throwDivisionByZero() {
+    throw std::invalid_argument("Деление на ноль");
+}
+
+BigNat BigNat::fromWords(std::uint64_t low, std::uint64_t high) {
+    if (high == 0)
+        return {low};
+
+    return fromLimbs({lowHalf(low), highHalf(low), lowHalf(high), highHalf(high)});
+}
+
+BigNat BigNat::parse(std::string_view text) {
+    const auto first = text.find_first_not_of(" \t\r\n");
+    const auto last = text.find_last_not_of(" \t\r\n");
+    if (first == std::string_view::npos)
+        throw std::invalid_argument("Ожидается натуральное число");
+
+    text = text.substr(first, last - first + 1);
+    if (!std::ranges::all_of(text, [](char ch) { return ch >= '0' && ch <= '9'; }))
+        throw std::invalid_argument("Ожидается натуральное число");
+
+    // Короткие записи разбираются сразу в машинное слово
+    if (std::uint64_t value; std::from_chars(text.data(), text.data() + text.size(), value).ec == std::errc{})
+        return {value};
+
+    Limbs digits;
+    std::size_t position = text.size() % decimalChunkDigits;
+    if (position == 0)
+        position = decimalChunkDigits;
+
+    Limb chunk = 0;
+    std::from_chars(text.data(), text.data() + position, chunk);
+    digits.push_back(chunk);
+
+    for (; position < text.size(); position += decimalChunkDigits) {
+        std::from_chars(text.data() + position, text.data() + position + decimalChunkDigits, chunk);
+        multiplyAddSmall(digits, decimalChunk, chunk);
+    }
+
+    return fromLimbs(std::move(digits));
+}
+
+unsigned BigNat::toUnsigned() const {
+    if (!isSmall() || small > UINT_MAX)
+        throw std::overflow_error("Число слишком велико");
+
+    return static_cast<unsigned>(small);
+}
+
+std::string BigNat::toString() const {
+    if (isSmall())
+        return std::to_string(small);
+
+    Limbs digits = limbs;
+    std::vector<Limb> chunks;
+    while (!digits.empty())
+        chunks.push_back(divideSmall(digits, decimalChunk));
+
+    std::string result = std::to_string(chunks.back());
+    for (std::size_t i = chunks.size() - 1; i-- > 0;) {
+        const std::string part = std::to_string(chunks[i]);
+        result.append(decimalChunkDigits - part.size(), '0');
+        result += part;
+    }
+
+    return result;
+}
+
+std::ostream &operator<<(std::ostream &os, const BigNat &number) {
+    return os << number.toString();
+}
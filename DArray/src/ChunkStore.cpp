@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "../include/ChunkStore.hpp"
+
+ChunkStore::Pin::Pin(Handle handle, bool forWrite) : handle(handle) {
+    ChunkStore &store = instance();
+    const std::lock_guard lock(store.mutex);
+    values = store.makeResident(handle, forWrite);
+    ++store.chunks[handle].pins;
+}
+
+ChunkStore::Pin::~Pin() {
+    ChunkStore &store = instance();
+    const std::lock_guard lock(store.mutex);
+    --store.chunks[handle].pins;
+}
+
+ChunkStore::~ChunkStore() {
+    for (const Chunk &chunk: chunks)
+        delete[] chunk.data;
+
+    if (spillFile)
+        std::fclose(spillFile);
+}
+
+ChunkStore &ChunkStore::instance() {
+    static ChunkStore store;
+
+    return store;
+}
+
+ChunkStore::Handle ChunkStore::allocate() {
+    ChunkStore &store = instance();
+    const std::lock_guard lock(store.mutex);
+
+    Handle handle;
+    if (!store.freeHandles.empty()) {
+        handle = store.freeHandles.back();
+        store.freeHandles.pop_back();
+    } else {
+        handle = static_cast<Handle>(store.chunks.size());
+        store.chunks.emplace_back();
+    }
+
+    store.evictUntilFits();
+
+    Chunk &chunk = store.chunks[handle];
+    chunk.data = new int[chunkSize]();
+    chunk.slot = -1;
+    chunk.pins = 0;
+    chunk.dirty = true;
+    chunk.lruPosition = store.lru.insert(store.lru.end(), handle);
+    store.residentBytes += chunkBytes;
+
+    return handle;
+}
+
+void ChunkStore::release(Handle handle) {
+    ChunkStore &store = instance();
+    const std::lock_guard lock(store.mutex);
+    Chunk &chunk = store.chunks[handle];
+
+    if (chunk.data) {
+        delete[] chunk.data;
+        chunk.data = nullptr;
+        store.lru.erase(chunk.lruPosition);
+        store.residentBytes -= chunkBytes;
+    }
+
+    if (chunk.slot >= 0)
+        store.freeSlots.push_back(chunk.slot);
+
+    chunk.slot = -1;
+    store.freeHandles.push_back(handle);
+}
+
+int ChunkStore::read(Handle handle, unsigned index) {
+    ChunkStore &store = instance();
+    const std::lock_guard lock(store.mutex);
+
+    return store.makeResident(handle, false)[index];
+}
+
+void ChunkStore::write(Handle handle, unsigned index, int value) {
+    ChunkStore &store = instance();
+    const std::lock_guard lock(store.mutex);
+    store.makeResident(handle, true)[index] = value;
+}
+
+void ChunkStore::setMemoryBudget(std::size_t bytes) {
+    ChunkStore &store = instance();
+    const std::lock_guard lock(store.mutex);
+    store.memoryBudget = std::max(bytes, chunkBytes);
+    store.evictUntilFits();
+}
+
+std::size_t ChunkStore::getMemoryBudget() {
+    ChunkStore &store = instance();
+    const std::lock_guard lock(store.mutex);
+
+    return store.memoryBudget;
+}
+
+std::size_t ChunkStore::getResidentBytes() {
+    ChunkStore &store = instance();
+    const std::lock_guard lock(store.mutex);
+
+    return store.residentBytes;
+}
+
+int *ChunkStore::makeResident(Handle handle, bool forWrite) {
+    Chunk &chunk = chunks[handle];
+    if (chunk.data) {
+        touch(handle);
+        chunk.dirty = chunk.dirty || forWrite;
+
+        return chunk.data;
+    }
+
+    evictUntilFits();
+
+    auto *values = new int[chunkSize];
+    if (std::fseek(spillFile, chunk.slot * static_cast<long>(chunkBytes), SEEK_SET) != 0 ||
+        std::fread(values, sizeof(int), chunkSize, spillFile) != chunkSize) {
+        delete[] values;
+        throw std::runtime_error("Не удалось прочитать блок вектора из временного файла");
+    }
+
+    chunk.data = values;
+    chunk.dirty = forWrite;
+    chunk.lruPosition = lru.insert(lru.end(), handle);
+    residentBytes += chunkBytes;
+
+    return values;
+}
+
+void ChunkStore::evictUntilFits() {
+    auto it = lru.begin();
+    while (residentBytes + chunkBytes > memoryBudget && it != lru.end()) {
+        const Handle victim = *it++;
+        if (chunks[victim].pins == 0)
+            spill(victim);
+    }
+}
+
+void ChunkStore::spill(Handle handle) {
+    Chunk &chunk = chunks[handle];
+
+    if (!spillFile) {
+        spillFile = std::tmpfile();
+        if (!spillFile)
+            throw std::runtime_error("Не удалось создать временный файл для векторов");
+    }
+
+    if (chunk.slot < 0) {
+        if (!freeSlots.empty()) {
+            chunk.slot = freeSlots.back();
+            freeSlots.pop_back();
+        } else
+            chunk.slot = nextSlot++;
+        chunk.dirty = true;
+    }
+
+    if (chunk.dirty) {
+        if (std::fseek(spillFile, chunk.slot * static_cast<long>(chunkBytes), SEEK_SET) != 0 ||
+            std::fwrite(chunk.data, sizeof(int), chunkSize, spillFile) != chunkSize)
+            throw std::runtime_error("Не удалось записать блок вектора во временный файл");
+    }
+
+    delete[] chunk.data;
+    chunk.data = nullptr;
+    lru.erase(chunk.lruPosition);
+    residentBytes -= chunkBytes;
+}
+
+void ChunkStore::touch(Handle handle) {
+    Chunk &chunk = chunks[handle];
+    lru.splice(lru.end(), lru, chunk.lruPosition);
+}
@@ -1,100 +1,248 @@
 #include <stdexcept>
 #include <iostream>
 #include <ranges>
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstring>
+#include <queue>
+#include <thread>
 
 #include "../include/DArray.hpp"
 
+namespace {
+    constexpr std::size_t parallelSortThreshold = std::size_t{1} << 16; // меньшие массивы сортируются в одном потоке
+    constexpr unsigned maxSortThreads = 16;
+    constexpr unsigned radixBits = 8;
+    constexpr unsigned radixSize = 1U << radixBits;
+    constexpr unsigned signBit = 0x80000000U; // инвертируется, чтобы отрицательные ключи шли раньше
+
+    // Элементы векторов — натуральные числа не больше INT_MAX. Результат вне этих границ — ошибка
+    // с тем же сообщением, что и у операций над числами стека
+    void throwElementOverflow() {
+        throw std::overflow_error("Число слишком велико для элемента вектора");
+    }
+
+    int checkedAdd(int a, int b) {
+        int sum;
+        if (__builtin_add_overflow(a, b, &sum))
+            throwElementOverflow();
+
+        return sum;
+    }
+
+    int checkedSub(int a, int b) {
+        int difference;
+        if (a < b || __builtin_sub_overflow(a, b, &difference))
+            throw std::domain_error("Результат вычитания не является натуральным числом");
+
+        return difference;
+    }
+
+    int checkedMul(int a, int b) {
+        int product;
+        if (__builtin_mul_overflow(a, b, &product))
+            throwElementOverflow();
+
+        return product;
+    }
+
+    // Поразрядная сортировка LSD: каждый поток строит гистограмму своей части массива,
+    // после чего части раскладываются по общим смещениям независимо друг от друга
+    void radixSort(std::vector<unsigned> &keys) {
+        const std::size_t count = keys.size();
+        const unsigned threads = count < parallelSortThreshold
+                                     ? 1
+                                     : std::clamp(std::thread::hardware_concurrency(), 1U, maxSortThreads);
+        const std::size_t part = (count + threads - 1) / threads;
+
+        std::vector<unsigned> buffer(count);
+        std::vector<std::array<std::size_t, radixSize>> offsets(threads);
+
+        auto forEachPart = [&](auto &&body) {
+            if (threads == 1) {
+                body(0U, std::size_t{0}, count);
+                return;
+            }
+
+            std::vector<std::thread> workers;
+            for (unsigned t = 0; t < threads; ++t)
+                workers.emplace_back(body, t, std::min(count, t * part), std::min(count, (t + 1) * part));
+            for (std::thread &worker: workers)
+                worker.join();
+        };
+
+        for (unsigned shift = 0; shift < 32; shift += radixBits) {
+            forEachPart([&](unsigned t, std::size_t first, std::size_t last) {
+                offsets[t].fill(0);
+                for (std::size_t i = first; i < last; ++i)
+                    ++offsets[t][(keys[i] >> shift) & (radixSize - 1)];
+            });
+
+            std::size_t total = 0;
+            for (unsigned digit = 0; digit < radixSize; ++digit)
+                for (unsigned t = 0; t < threads; ++t) {
+                    const std::size_t digitCount = offsets[t][digit];
+                    offsets[t][digit] = total;
+                    total += digitCount;
+                }
+
+            forEachPart([&](unsigned t, std::size_t first, std::size_t last) {
+                for (std::size_t i = first; i < last; ++i)
+                    buffer[offsets[t][(keys[i] >> shift) & (radixSize - 1)]++] = keys[i];
+            });
+
+            keys.swap(buffer);
+        }
+    }
+}
+
 void DArray::checkVectorSize(const DArray &left, const DArray &right) {
     if (left.size != right.size)
         throw std::invalid_argument("Несоответствие размера вектора");
 }
 
 void DArray::checkDivisionByZero(const DArray &right) {
-    for (Node *current = right.head; current; current = current->next)
-        if (current->value == 0)
-            throw std::invalid_argument("Деление на ноль");
+    for (std::size_t chunk = 0; chunk < right.chunks.size(); ++chunk) {
+        const ChunkStore::Pin values(right.chunks[chunk], false);
+        const unsigned length = right.chunkLength(chunk);
+        for (unsigned i = 0; i < length; ++i)
+            if (values[i] == 0)
+                throw std::invalid_argument("Деление на ноль");
+    }
 }
 
-void DArray::copyFrom(const DArray &other) {
-    for (Node *current = other.head; current != nullptr; current = current->next)
-        push_back(current->value);
-}
+void DArray::copyElements(const DArray &source, unsigned sourcePos, DArray &destination, unsigned destinationPos,
+                          unsigned count) {
+    while (count > 0) {
+        const unsigned sourceOffset = sourcePos % ChunkStore::chunkSize;
+        const unsigned destinationOffset = destinationPos % ChunkStore::chunkSize;
+        const unsigned length = std::min({
+            count, ChunkStore::chunkSize - sourceOffset, ChunkStore::chunkSize - destinationOffset
+        });
 
-void DArray::clear() {
-    while (head) {
-        Node *temp = head;
-        head = head->next;
-        delete temp;
+        const ChunkStore::Pin from(source.chunks[sourcePos / ChunkStore::chunkSize], false);
+        const ChunkStore::Pin to(destination.chunks[destinationPos / ChunkStore::chunkSize], true);
+        std::memmove(to.data() + destinationOffset, from.data() + sourceOffset, length * sizeof(int));
+
+        sourcePos += length;
+        destinationPos += length;
+        count -= length;
     }
+}
 
-    tail = nullptr;
-    size = 0;
+unsigned DArray::chunkLength(std::size_t chunk) const {
+    const std::size_t first = chunk * ChunkStore::chunkSize;
+
+    return static_cast<unsigned>(std::min<std::size_t>(ChunkStore::chunkSize, size - first));
 }
 
-DArray &DArray::applyBinaryAssignment(const DArray &right, void (*op)(int &, int)) {
-    checkVectorSize(*this, right);
-    Node *leftCurrent = head;
-    Node *rightCurrent = right.head;
-    while (leftCurrent) {
-        op(leftCurrent->value, rightCurrent->value);
-        leftCurrent = leftCurrent->next;
-        rightCurrent = rightCurrent->next;
+void DArray::resize(unsigned newSize) {
+    const std::size_t needed = (static_cast<std::size_t>(newSize) + ChunkStore::chunkSize - 1) / ChunkStore::chunkSize;
+    while (chunks.size() < needed)
+        chunks.push_back(ChunkStore::allocate());
+
+    while (chunks.size() > needed) {
+        ChunkStore::release(chunks.back());
+        chunks.pop_back();
     }
 
-    return *this;
+    // Хвост последнего блока обнуляется, чтобы последующий рост не открыл старые значения
+    if (newSize < size && newSize % ChunkStore::chunkSize != 0) {
+        const ChunkStore::Pin values(chunks.back(), true);
+        std::fill(values.data() + newSize % ChunkStore::chunkSize, values.data() + ChunkStore::chunkSize, 0);
+    }
+
+    size = newSize;
+}
+
+void DArray::copyFrom(const DArray &other) {
+    resize(other.size);
+    copyElements(other, 0, *this, 0, other.size);
+}
+
+void DArray::clear() {
+    for (const ChunkStore::Handle handle: chunks)
+        ChunkStore::release(handle);
+
+    chunks.clear();
+    size = 0;
 }
 
 DArray DArray::applyBinaryOperation(const DArray &right, int (*op)(int, int)) const {
     checkVectorSize(*this, right);
     DArray result;
-    Node *leftCurrent = head;
-    Node *rightCurrent = right.head;
-    while (leftCurrent) {
-        result.push_back(op(leftCurrent->value, rightCurrent->value));
-        leftCurrent = leftCurrent->next;
-        rightCurrent = rightCurrent->next;
+    result.resize(size);
+    for (std::size_t chunk = 0; chunk < chunks.size(); ++chunk) {
+        const ChunkStore::Pin leftValues(chunks[chunk], false);
+        const ChunkStore::Pin rightValues(right.chunks[chunk], false);
+        const ChunkStore::Pin resultValues(result.chunks[chunk], true);
+        const unsigned length = chunkLength(chunk);
+        for (unsigned i = 0; i < length; ++i)
+            resultValues[i] = op(leftValues[i], rightValues[i]);
     }
 
     return result;
 }
 
-DArray::DArray() : size(0), head(nullptr), tail(nullptr) {}
+DArray::DArray() : size(0) {}
+
+DArray::DArray(const DArray &other) : size(0) { copyFrom(other); }
+
+DArray::DArray(DArray &&other) noexcept : size(other.size), chunks(std::move(other.chunks)) {
+    other.chunks.clear();
+    other.size = 0;
+}
+
+DArray::DArray(const std::vector<unsigned> &vec) : size(0) {
+    if (std::ranges::any_of(vec, [](unsigned value) { return value > static_cast<unsigned>(INT_MAX); }))
+        throwElementOverflow();
 
-DArray::DArray(const DArray &other) : size(0), head(nullptr), tail(nullptr) { copyFrom(other); }
+    resize(static_cast<unsigned>(vec.size()));
+    for (std::size_t chunk = 0; chunk < chunks.size(); ++chunk) {
+        const ChunkStore::Pin values(chunks[chunk], true);
+        const unsigned length = chunkLength(chunk);
+        for (unsigned i = 0; i < length; ++i)
+            values[i] = static_cast<int>(vec[chunk * ChunkStore::chunkSize + i]);
+    }
+}
 
-DArray::DArray(const std::vector<unsigned> &vec) : size(0), head(nullptr), tail(nullptr) {
-    for (const auto &value: vec)
-        push_back(static_cast<int>(value));
+DArray::DArray(const int *values, unsigned count) : size(0) {
+    resize(count);
+    for (std::size_t chunk = 0; chunk < chunks.size(); ++chunk) {
+        const ChunkStore::Pin destination(chunks[chunk], true);
+        std::memcpy(destination.data(), values + chunk * ChunkStore::chunkSize, chunkLength(chunk) * sizeof(int));
+    }
 }
 
 DArray::~DArray() { clear(); }
 
 DArray DArray::operator+(const DArray &right) const {
-    return applyBinaryOperation(right, [](int a, int b) { return a + b; });
+    return applyBinaryOperation(right, checkedAdd);
 }
 
 DArray &DArray::operator+=(const DArray &right) {
-    applyBinaryAssignment(right, [](int &a, int b) { a += b; });
+    *this = *this + right;
 
     return *this;
 }
 
 DArray DArray::operator-(const DArray &right) const {
-    return applyBinaryOperation(right, [](int a, int b) { return a - b; });
+    return applyBinaryOperation(right, checkedSub);
 }
 
 DArray &DArray::operator-=(const DArray &right) {
-    applyBinaryAssignment(right, [](int &a, int b) { a -= b; });
+    *this = *this - right;
 
     return *this;
 }
 
 DArray DArray::operator*(const DArray &right) const {
-    return applyBinaryOperation(right, [](int a, int b) { return a * b; });
+    return applyBinaryOperation(right, checkedMul);
 }
 
 DArray &DArray::operator*=(const DArray &right) {
-    applyBinaryAssignment(right, [](int &a, int b) { a *= b; });
+    *this = *this * right;
 
     return *this;
 }
@@ -106,8 +254,7 @@ DArray DArray::operator/(const DArray &right) const {
 }
 
 DArray &DArray::operator/=(const DArray &right) {
-    checkDivisionByZero(right);
-    applyBinaryAssignment(right, [](int &a, int b) { a /= b; });
+    *this = *this / right;
 
     return *this;
 }
@@ -119,46 +266,45 @@ DArray DArray::operator%(const DArray &right) const {
 }
 
 DArray &DArray::operator%=(const DArray &right) {
-    checkDivisionByZero(right);
-    applyBinaryAssignment(right, [](int &a, int b) { a %= b; });
+    *this = *this % right;
 
     return *this;
 }
 
-int DArray::dot(const DArray &right) const {
+BigNat DArray::dot(const DArray &right) const {
     checkVectorSize(*this, right);
-    int result = 0;
-    Node *leftCurrent = head;
-    Node *rightCurrent = right.head;
-    while (leftCurrent) {
-        result += leftCurrent->value * rightCurrent->value;
-        leftCurrent = leftCurrent->next;
-        rightCurrent = rightCurrent->next;
+    // Произведения пар int точно помещаются в 64 бита, а сумма до 2^32 таких произведений — в 128
+    __extension__ using Accumulator = __int128;
+    Accumulator result = 0;
+    for (std::size_t chunk = 0; chunk < chunks.size(); ++chunk) {
+        const ChunkStore::Pin leftValues(chunks[chunk], false);
+        const ChunkStore::Pin rightValues(right.chunks[chunk], false);
+        const unsigned length = chunkLength(chunk);
+        for (unsigned i = 0; i < length; ++i)
+            result += static_cast<long long>(leftValues[i]) * rightValues[i];
     }
 
-    return result;
+    if (result < 0)
+        throw std::domain_error("Скалярное произведение не является натуральным числом");
+
+    __extension__ using Magnitude = unsigned __int128;
+    const auto magnitude = static_cast<Magnitude>(result);
+
+    return BigNat::fromWords(static_cast<std::uint64_t>(magnitude), static_cast<std::uint64_t>(magnitude >> 64));
 }
 
-int &DArray::operator[](unsigned index) {
+int DArray::operator[](unsigned index) const {
     if (index >= size)
         throw std::out_of_range("Индекс вне диапазона");
 
-    Node *current = head;
-    for (size_t i = 0; i < index; i++)
-        current = current->next;
-
-    return current->value;
+    return ChunkStore::read(chunks[index / ChunkStore::chunkSize], index % ChunkStore::chunkSize);
 }
 
-const int &DArray::operator[](unsigned index) const {
+void DArray::set(unsigned index, int value) {
     if (index >= size)
         throw std::out_of_range("Индекс вне диапазона");
 
-    Node *current = head;
-    for (size_t i = 0; i < index; i++)
-        current = current->next;
-
-    return current->value;
+    ChunkStore::write(chunks[index / ChunkStore::chunkSize], index % ChunkStore::chunkSize, value);
 }
 
 DArray &DArray::operator=(const DArray &right) {
@@ -170,18 +316,27 @@ DArray &DArray::operator=(const DArray &right) {
     return *this;
 }
 
+DArray &DArray::operator=(DArray &&right) noexcept {
+    if (this != &right) {
+        clear();
+        chunks = std::move(right.chunks);
+        size = right.size;
+        right.chunks.clear();
+        right.size = 0;
+    }
+
+    return *this;
+}
+
 bool DArray::operator==(const DArray &right) const {
     if (size != right.size)
         return false;
 
-    Node *leftCurrent = head;
-    Node *rightCurrent = right.head;
-    while (leftCurrent) {
-        if (leftCurrent->value != rightCurrent->value)
+    for (std::size_t chunk = 0; chunk < chunks.size(); ++chunk) {
+        const ChunkStore::Pin leftValues(chunks[chunk], false);
+        const ChunkStore::Pin rightValues(right.chunks[chunk], false);
+        if (std::memcmp(leftValues.data(), rightValues.data(), chunkLength(chunk) * sizeof(int)) != 0)
             return false;
-        
-        leftCurrent = leftCurrent->next;
-        rightCurrent = rightCurrent->next;
     }
 
     return true;
@@ -193,134 +348,63 @@ bool DArray::operator!=(const DArray &right) const {
 
 DArray DArray::operator&(const DArray &right) const {
     DArray res;
-    Node *leftCurrent = head;
-    while (leftCurrent) {
-        res.push_back(leftCurrent->value);
-        leftCurrent = leftCurrent->next;
-    }
-
-    Node *rightCurrent = right.head;
-    while (rightCurrent) {
-        res.push_back(rightCurrent->value);
-        rightCurrent = rightCurrent->next;
-    }
+    res.resize(size + right.size);
+    copyElements(*this, 0, res, 0, size);
+    copyElements(right, 0, res, size, right.size);
 
     return res;
 }
 
 DArray &DArray::operator&=(const DArray &right) {
-    Node *rightCurrent = right.head;
-    while (rightCurrent) {
-        push_back(rightCurrent->value);
-        rightCurrent = rightCurrent->next;
-    }
+    const unsigned oldSize = size;
+    const unsigned rightSize = right.size;
+    resize(oldSize + rightSize);
+    copyElements(right, 0, *this, oldSize, rightSize);
 
     return *this;
 }
 
 DArray DArray::operator<<(unsigned shift) const {
     DArray newArray;
+    newArray.resize(size);
 
-    if (shift >= size) {
-        for (size_t i = 0; i < size; ++i)
-            newArray.push_back(0);
-    } else {
-        Node *current = head;
-        for (size_t i = 0; i < shift; ++i)
-            current = current->next;
-
-        for (size_t i = 0; i < size - shift; ++i) {
-            newArray.push_back(current->value);
-            current = current->next;
-        }
-
-        for (size_t i = size - shift; i < size; ++i)
-            newArray.push_back(0);
-    }
+    if (shift < size)
+        copyElements(*this, shift, newArray, 0, size - shift);
 
     return newArray;
 }
 
 DArray DArray::operator>>(unsigned shift) const {
     DArray newArray;
-    if (shift >= size)
-        for (size_t i = 0; i < size; ++i)
-            newArray.push_back(0);
-    else {
-        for (size_t i = 0; i < shift; ++i)
-            newArray.push_back(0);
-
-        Node *current = head;
-        for (size_t i = 0; i < size - shift; ++i) {
-            newArray.push_back(current->value);
-            current = current->next;
-        }
-    }
+    newArray.resize(size);
+
+    if (shift < size)
+        copyElements(*this, 0, newArray, shift, size - shift);
 
     return newArray;
 }
 
 DArray &DArray::operator<<=(unsigned shift) {
-    if (shift >= size) {
-        Node *current = head;
-        while (current != nullptr) {
-            current->value = 0;
-            current = current->next;
-        }
-    } else {
-        Node *newHead = head;
-        for (size_t i = 0; i < shift; ++i) {
-            if (newHead != nullptr)
-                newHead = newHead->next;
-        }
-
-        Node *oldHead = head;
-        while (newHead != nullptr) {
-            oldHead->value = newHead->value;
-            oldHead = oldHead->next;
-            newHead = newHead->next;
-        }
-
-        while (oldHead != nullptr) {
-            oldHead->value = 0;
-            oldHead = oldHead->next;
-        }
-    }
+    *this = *this << shift;
 
     return *this;
 }
 
 DArray &DArray::operator>>=(unsigned shift) {
-    if (shift >= size) {
-        Node *current = head;
-        while (current) {
-            current->value = 0;
-            current = current->next;
-        }
-    } else {
-        Node *current = tail;
-        for (size_t i = size - 1; i >= shift; --i) {
-            current->value = current->prev ? current->prev->value : 0;
-            current = current->prev;
-        }
-
-        current = head;
-        for (size_t i = 0; i < shift; ++i) {
-            current->value = 0;
-            current = current->next;
-        }
-    }
+    *this = *this >> shift;
 
     return *this;
 }
 
-DArray::Iterator::Iterator(Node *node) : current(node) {}
+DArray::Iterator::Iterator(const DArray *array, unsigned index) : array(array), index(index) {}
 
-int &DArray::Iterator::operator*() const { return current->value; }
+int DArray::Iterator::operator*() const {
+    return ChunkStore::read(array->chunks[index / ChunkStore::chunkSize], index % ChunkStore::chunkSize);
+}
 
 DArray::Iterator &DArray::Iterator::operator++() {
-    if (current)
-        current = current->next;
+    if (array && ++index >= array->size)
+        array = nullptr;
 
     return *this;
 }
@@ -333,8 +417,8 @@ DArray::Iterator DArray::Iterator::operator++(int) {
 }
 
 DArray::Iterator &DArray::Iterator::operator--() {
-    if (current)
-        current = current->prev;
+    if (array && index-- == 0)
+        array = nullptr;
 
     return *this;
 }
@@ -346,13 +430,15 @@ DArray::Iterator DArray::Iterator::operator--(int) {
     return temp;
 }
 
-bool DArray::Iterator::operator==(const Iterator &other) const { return current == other.current; }
+bool DArray::Iterator::operator==(const Iterator &other) const {
+    return array == other.array && (array == nullptr || index == other.index);
+}
 
-bool DArray::Iterator::operator!=(const Iterator &other) const { return current != other.current; }
+bool DArray::Iterator::operator!=(const Iterator &other) const { return !(*this == other); }
 
-DArray::Iterator DArray::begin() const { return Iterator(head); }
+DArray::Iterator DArray::begin() const { return size ? Iterator(this, 0) : end(); }
 
-DArray::Iterator DArray::end() { return Iterator(nullptr); }
+DArray::Iterator DArray::end() { return {nullptr, 0}; }
 
 std::ostream& operator<<(std::ostream& os, const DArray& arr) {
     os << "<<";
@@ -398,6 +484,8 @@ std::istream& operator>>(std::istream& is, DArray& arr) {
         is >> std::ws;
         if (!(is >> value))
             throw std::invalid_argument("Ожидается числовое значение");
+        if (value < 0)
+            throw std::invalid_argument("Ожидается натуральное число");
 
         arr.push_back(value);
     }
@@ -409,16 +497,187 @@ std::istream& operator>>(std::istream& is, DArray& arr) {
 }
 
 void DArray::push_back(int value) {
-    auto newNode = new Node(value);
-    if (!tail)
-        head = newNode;
-    else {
-        tail->next = newNode;
-        newNode->prev = tail;
+    const unsigned index = size;
+    resize(size + 1);
+    ChunkStore::write(chunks[index / ChunkStore::chunkSize], index % ChunkStore::chunkSize, value);
+}
+
+unsigned DArray::getSize() const { return size; }
+
+void DArray::copyTo(int *destination) const {
+    for (std::size_t chunk = 0; chunk < chunks.size(); ++chunk) {
+        const ChunkStore::Pin source(chunks[chunk], false);
+        std::memcpy(destination + chunk * ChunkStore::chunkSize, source.data(), chunkLength(chunk) * sizeof(int));
+    }
+}
+
+unsigned DArray::sortRunLength() {
+    const std::size_t budgetElements = ChunkStore::getMemoryBudget() / 2 / (2 * sizeof(unsigned));
+
+    return static_cast<unsigned>(std::min<std::size_t>(
+        std::max<std::size_t>(budgetElements / ChunkStore::chunkSize, 1) * ChunkStore::chunkSize, UINT_MAX));
+}
+
+void DArray::sortRun(unsigned first, unsigned count) {
+    std::vector<unsigned> keys(count);
+    const std::size_t firstChunk = first / ChunkStore::chunkSize;
+    const std::size_t lastChunk = (static_cast<std::size_t>(first) + count - 1) / ChunkStore::chunkSize;
+
+    for (std::size_t chunk = firstChunk; chunk <= lastChunk; ++chunk) {
+        const ChunkStore::Pin values(chunks[chunk], false);
+        const std::size_t offset = (chunk - firstChunk) * ChunkStore::chunkSize;
+        std::transform(values.data(), values.data() + chunkLength(chunk),
+                       keys.begin() + static_cast<std::ptrdiff_t>(offset),
+                       [](int value) { return static_cast<unsigned>(value) ^ signBit; });
+    }
+
+    radixSort(keys);
+
+    for (std::size_t chunk = firstChunk; chunk <= lastChunk; ++chunk) {
+        const ChunkStore::Pin values(chunks[chunk], true);
+        const std::size_t offset = (chunk - firstChunk) * ChunkStore::chunkSize;
+        std::transform(keys.begin() + static_cast<std::ptrdiff_t>(offset),
+                       keys.begin() + static_cast<std::ptrdiff_t>(offset + chunkLength(chunk)), values.data(),
+                       [](unsigned key) { return static_cast<int>(key ^ signBit); });
+    }
+}
+
+void DArray::mergeRuns(unsigned runLength) {
+    // Из каждой серии в памяти держится только блок с её текущим элементом
+    struct Cursor {
+        unsigned position;
+        unsigned end;
+        std::vector<int> buffer;
+    };
+
+    auto load = [this](Cursor &cursor) {
+        const std::size_t chunk = cursor.position / ChunkStore::chunkSize;
+        const ChunkStore::Pin values(chunks[chunk], false);
+        cursor.buffer.assign(values.data(), values.data() + chunkLength(chunk));
+    };
+    auto head = [](const Cursor &cursor) { return cursor.buffer[cursor.position % ChunkStore::chunkSize]; };
+
+    std::vector<Cursor> cursors;
+    for (unsigned first = 0; first < size; first += std::min(runLength, size - first)) {
+        cursors.push_back({first, first + std::min(runLength, size - first), {}});
+        load(cursors.back());
+    }
+
+    auto greater = [&](std::size_t a, std::size_t b) { return head(cursors[a]) > head(cursors[b]); };
+    std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(greater)> queue(greater);
+    for (std::size_t run = 0; run < cursors.size(); ++run)
+        queue.push(run);
+
+    DArray result;
+    result.resize(size);
+    std::vector<int> output;
+    output.reserve(ChunkStore::chunkSize);
+    std::size_t outputChunk = 0;
+    auto flush = [&] {
+        const ChunkStore::Pin destination(result.chunks[outputChunk++], true);
+        std::memcpy(destination.data(), output.data(), output.size() * sizeof(int));
+        output.clear();
+    };
+
+    while (!queue.empty()) {
+        const std::size_t run = queue.top();
+        queue.pop();
+
+        Cursor &cursor = cursors[run];
+        output.push_back(head(cursor));
+        if (output.size() == ChunkStore::chunkSize)
+            flush();
+
+        if (++cursor.position < cursor.end) {
+            if (cursor.position % ChunkStore::chunkSize == 0)
+                load(cursor);
+            queue.push(run);
+        }
+    }
+
+    if (!output.empty())
+        flush();
+
+    *this = std::move(result);
+}
+
+void DArray::sort() {
+    if (size == 0)
+        return;
+
+    // Буферы поразрядной сортировки занимают не больше половины бюджета памяти. Больший массив
+    // сортируется сериями такого размера, которые затем сливаются поблочно
+    const unsigned runLength = sortRunLength();
+    for (unsigned first = 0; first < size; first += std::min(runLength, size - first))
+        sortRun(first, std::min(runLength, size - first));
+
+    if (size > runLength)
+        mergeRuns(runLength);
+}
+
+unsigned DArray::find(int value) const {
+    unsigned first = 0;
+    unsigned count = size;
+    while (count > 0) {
+        const unsigned step = count / 2;
+        if ((*this)[first + step] < value) {
+            first += step + 1;
+            count -= step + 1;
+        } else
+            count = step;
+    }
+
+    return first < size && (*this)[first] == value ? first : size;
+}
+
+void DArray::unique() {
+    if (size == 0)
+        return;
+
+    unsigned written = 1;
+    int last = (*this)[0];
+    for (unsigned read = 1; read < size; ++read) {
+        const int value = (*this)[read];
+        if (value != last) {
+            set(written++, value);
+            last = value;
+        }
+    }
+
+    resize(written);
+}
+
+DArray DArray::gather(const DArray &indices) const {
+    DArray result;
+    result.resize(indices.size);
+    for (std::size_t chunk = 0; chunk < indices.chunks.size(); ++chunk) {
+        const ChunkStore::Pin indexValues(indices.chunks[chunk], false);
+        const ChunkStore::Pin resultValues(result.chunks[chunk], true);
+        const unsigned length = indices.chunkLength(chunk);
+        for (unsigned i = 0; i < length; ++i)
+            resultValues[i] = (*this)[static_cast<unsigned>(indexValues[i])];
     }
 
-    tail = newNode;
-    ++size;
+    return result;
 }
 
-unsigned DArray::getSize() const { return size; }
\ No newline at end of file
+void DArray::scatter(const DArray &indices, const DArray &values) {
+    checkVectorSize(indices, values);
+
+    // Индексы проверяются до записи, чтобы при ошибке массив остался прежним
+    for (std::size_t chunk = 0; chunk < indices.chunks.size(); ++chunk) {
+        const ChunkStore::Pin indexValues(indices.chunks[chunk], false);
+        const unsigned length = indices.chunkLength(chunk);
+        for (unsigned i = 0; i < length; ++i)
+            if (static_cast<unsigned>(indexValues[i]) >= size)
+                throw std::out_of_range("Индекс вне диапазона");
+    }
+
+    for (std::size_t chunk = 0; chunk < indices.chunks.size(); ++chunk) {
+        const ChunkStore::Pin indexValues(indices.chunks[chunk], false);
+        const ChunkStore::Pin newValues(values.chunks[chunk], false);
+        const unsigned length = indices.chunkLength(chunk);
+        for (unsigned i = 0; i < length; ++i)
+            set(static_cast<unsigned>(indexValues[i]), newValues[i]);
+    }
+}
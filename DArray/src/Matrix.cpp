@@ -0,0 +1,295 @@
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+
+// Ядра AVX2 собираются отдельно от остального кода и выбираются при выполнении, если процессор их поддерживает,
+// поэтому сборка не требует -mavx2
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RGR4_MATRIX_AVX2 1
+#include <immintrin.h>
+#else
+#define RGR4_MATRIX_AVX2 0
+#endif
+
+#include "../include/Matrix.hpp"
+
+namespace {
+    __extension__ using WideSum = __int128;
+
+    bool hasAvx2() {
+#if RGR4_MATRIX_AVX2
+        static const bool supported = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+
+        return supported;
+#else
+        return false;
+#endif
+    }
+
+    std::uint64_t maxMagnitude(const int *values, std::size_t count) {
+        std::uint64_t result = 0;
+        for (std::size_t i = 0; i < count; ++i)
+            result = std::max(result, static_cast<std::uint64_t>(std::abs(static_cast<std::int64_t>(values[i]))));
+
+        return result;
+    }
+
+    // Сумма count произведений множителей не больше left и right по модулю, как и все её частичные суммы,
+    // помещается в 64 бита; иначе считается в 128
+    bool fitsInt64(std::uint64_t left, std::uint64_t right, unsigned count) {
+        __extension__ using Magnitude = unsigned __int128;
+
+        return static_cast<Magnitude>(left) * right * count <= static_cast<Magnitude>(INT64_MAX);
+    }
+
+    // Результат точный, как у vdot; элемент, не помещающийся в int, — ошибка, а не перенос по модулю 2^32
+    template<typename Sum>
+    int toElement(Sum sum) {
+        if (sum < INT_MIN || sum > INT_MAX)
+            throw std::overflow_error("Элемент произведения не помещается в int");
+
+        return static_cast<int>(sum);
+    }
+
+    // destination[j] += factor * source[j]
+    template<typename Sum>
+    void multiplyAddRow(Sum *__restrict destination, const int *__restrict source, int factor, unsigned count) {
+        for (unsigned j = 0; j < count; ++j)
+            destination[j] += static_cast<Sum>(factor) * source[j];
+    }
+
+    template<typename Sum>
+    Sum dotRow(const int *__restrict left, const int *__restrict right, unsigned count) {
+        Sum result = 0;
+        for (unsigned j = 0; j < count; ++j)
+            result += static_cast<Sum>(left[j]) * right[j];
+
+        return result;
+    }
+
+#if RGR4_MATRIX_AVX2
+    // _mm256_mul_epi32 умножает младшие 32 бита 64-битных полос со знаком, поэтому произведения точные
+    [[gnu::target("avx2")]]
+    void multiplyAddRowAvx2(std::int64_t *__restrict destination, const int *__restrict source, int factor,
+                            unsigned count) {
+        const __m256i factors = _mm256_set1_epi64x(factor);
+        unsigned j = 0;
+        for (; j + 4 <= count; j += 4) {
+            const __m256i row = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(source + j)));
+            __m256i sum = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(destination + j));
+            sum = _mm256_add_epi64(sum, _mm256_mul_epi32(row, factors));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + j), sum);
+        }
+
+        multiplyAddRow(destination + j, source + j, factor, count - j);
+    }
+
+    [[gnu::target("avx2")]]
+    std::int64_t dotRowAvx2(const int *__restrict left, const int *__restrict right, unsigned count) {
+        __m256i sum = _mm256_setzero_si256();
+        unsigned j = 0;
+        for (; j + 4 <= count; j += 4) {
+            const __m256i a = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(left + j)));
+            const __m256i b = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(right + j)));
+            sum = _mm256_add_epi64(sum, _mm256_mul_epi32(a, b));
+        }
+
+        alignas(32) std::int64_t lanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), sum);
+
+        return lanes[0] + lanes[1] + lanes[2] + lanes[3] + dotRow<std::int64_t>(left + j, right + j, count - j);
+    }
+#endif
+}
+
+Matrix::Matrix() : rows(0), columns(0) {}
+
+Matrix::Matrix(unsigned rows, unsigned columns)
+    : rows(rows), columns(columns), values(static_cast<std::size_t>(rows) * columns, 0) {}
+
+Matrix::Matrix(const DArray &elements, unsigned rows) : rows(rows), columns(0) {
+    if (rows == 0 || elements.getSize() % rows != 0)
+        throw std::invalid_argument("Размер вектора не делится на количество строк матрицы");
+
+    columns = elements.getSize() / rows;
+    values.resize(elements.getSize());
+    elements.copyTo(values.data());
+}
+
+unsigned Matrix::getRows() const { return rows; }
+
+unsigned Matrix::getColumns() const { return columns; }
+
+int &Matrix::operator()(unsigned row, unsigned column) {
+    if (row >= rows || column >= columns)
+        throw std::out_of_range("Индекс вне диапазона");
+
+    return values[static_cast<std::size_t>(row) * columns + column];
+}
+
+const int &Matrix::operator()(unsigned row, unsigned column) const {
+    if (row >= rows || column >= columns)
+        throw std::out_of_range("Индекс вне диапазона");
+
+    return values[static_cast<std::size_t>(row) * columns + column];
+}
+
+template<typename Sum>
+void Matrix::multiplyBlocked(const Matrix &right, Matrix &result) const {
+    const unsigned depth = columns;
+    const unsigned width = right.columns;
+    auto multiplyAdd = multiplyAddRow<Sum>;
+#if RGR4_MATRIX_AVX2
+    if constexpr (std::is_same_v<Sum, std::int64_t>)
+        if (hasAvx2())
+            multiplyAdd = multiplyAddRowAvx2;
+#endif
+
+    // Суммы накапливаются для одного блока строк и переводятся в элементы, когда блок готов
+    std::vector<Sum> sums(static_cast<std::size_t>(blockRows) * width);
+    for (unsigned rowBlock = 0; rowBlock < rows; rowBlock += blockRows) {
+        const unsigned rowEnd = std::min(rowBlock + blockRows, rows);
+        std::fill(sums.begin(), sums.end(), Sum{0});
+        for (unsigned depthBlock = 0; depthBlock < depth; depthBlock += blockDepth) {
+            const unsigned depthEnd = std::min(depthBlock + blockDepth, depth);
+            for (unsigned columnBlock = 0; columnBlock < width; columnBlock += blockColumns) {
+                const unsigned columnCount = std::min(blockColumns, width - columnBlock);
+                for (unsigned i = rowBlock; i < rowEnd; ++i) {
+                    Sum *sumRow = sums.data() + static_cast<std::size_t>(i - rowBlock) * width + columnBlock;
+                    for (unsigned k = depthBlock; k < depthEnd; ++k)
+                        multiplyAdd(sumRow, right.values.data() + static_cast<std::size_t>(k) * width + columnBlock,
+                                    values[static_cast<std::size_t>(i) * depth + k], columnCount);
+                }
+            }
+        }
+
+        const std::size_t blockElements = static_cast<std::size_t>(rowEnd - rowBlock) * width;
+        std::transform(sums.begin(), sums.begin() + static_cast<std::ptrdiff_t>(blockElements),
+                       result.values.begin() + static_cast<std::ptrdiff_t>(static_cast<std::size_t>(rowBlock) * width),
+                       toElement<Sum>);
+    }
+}
+
+Matrix Matrix::operator*(const Matrix &right) const {
+    if (columns != right.rows)
+        throw std::invalid_argument("Несоответствие размеров матриц");
+
+    Matrix result(rows, right.columns);
+    if (fitsInt64(maxMagnitude(values.data(), values.size()), maxMagnitude(right.values.data(), right.values.size()),
+                  columns))
+        multiplyBlocked<std::int64_t>(right, result);
+    else
+        multiplyBlocked<WideSum>(right, result);
+
+    return result;
+}
+
+DArray Matrix::operator*(const DArray &vector) const {
+    if (columns != vector.getSize())
+        throw std::invalid_argument("Несоответствие размеров матрицы и вектора");
+
+    std::vector<int> input(columns);
+    vector.copyTo(input.data());
+
+    std::vector<int> output(rows);
+    const bool narrow = fitsInt64(maxMagnitude(values.data(), values.size()), maxMagnitude(input.data(), columns),
+                                  columns);
+    auto dot = dotRow<std::int64_t>;
+#if RGR4_MATRIX_AVX2
+    if (hasAvx2())
+        dot = dotRowAvx2;
+#endif
+    for (unsigned i = 0; i < rows; ++i) {
+        const int *row = values.data() + static_cast<std::size_t>(i) * columns;
+        output[i] = narrow ? toElement(dot(row, input.data(), columns))
+                           : toElement(dotRow<WideSum>(row, input.data(), columns));
+    }
+
+    return {output.data(), rows};
+}
+
+bool Matrix::operator==(const Matrix &right) const {
+    return rows == right.rows && columns == right.columns && values == right.values;
+}
+
+bool Matrix::operator!=(const Matrix &right) const {
+    return !(*this == right);
+}
+
+Matrix Matrix::transpose() const {
+    Matrix result(columns, rows);
+
+    for (unsigned rowBlock = 0; rowBlock < rows; rowBlock += blockRows) {
+        const unsigned rowEnd = std::min(rowBlock + blockRows, rows);
+        for (unsigned columnBlock = 0; columnBlock < columns; columnBlock += blockRows) {
+            const unsigned columnEnd = std::min(columnBlock + blockRows, columns);
+            for (unsigned i = rowBlock; i < rowEnd; ++i)
+                for (unsigned j = columnBlock; j < columnEnd; ++j)
+                    result.values[static_cast<std::size_t>(j) * rows + i] =
+                            values[static_cast<std::size_t>(i) * columns + j];
+        }
+    }
+
+    return result;
+}
+
+DArray Matrix::row(unsigned index) const {
+    if (index >= rows)
+        throw std::out_of_range("Индекс строки вне диапазона");
+
+    return {values.data() + static_cast<std::size_t>(index) * columns, columns};
+}
+
+DArray Matrix::column(unsigned index) const {
+    if (index >= columns)
+        throw std::out_of_range("Индекс столбца вне диапазона");
+
+    std::vector<int> result(rows);
+    for (unsigned i = 0; i < rows; ++i)
+        result[i] = values[static_cast<std::size_t>(i) * columns + index];
+
+    return {result.data(), rows};
+}
+
+Matrix Matrix::rowSlice(unsigned first, unsigned count) const {
+    if (first > rows || count > rows - first)
+        throw std::out_of_range("Диапазон строк вне матрицы");
+
+    Matrix result(count, columns);
+    std::copy_n(values.begin() + static_cast<std::ptrdiff_t>(static_cast<std::size_t>(first) * columns),
+                static_cast<std::size_t>(count) * columns, result.values.begin());
+
+    return result;
+}
+
+Matrix Matrix::columnSlice(unsigned first, unsigned count) const {
+    if (first > columns || count > columns - first)
+        throw std::out_of_range("Диапазон столбцов вне матрицы");
+
+    Matrix result(rows, count);
+    for (unsigned i = 0; i < rows; ++i)
+        std::copy_n(values.begin() + static_cast<std::ptrdiff_t>(static_cast<std::size_t>(i) * columns + first),
+                    count, result.values.begin() + static_cast<std::ptrdiff_t>(static_cast<std::size_t>(i) * count));
+
+    return result;
+}
+
+std::ostream &operator<<(std::ostream &os, const Matrix &matrix) {
+    os << '[';
+    for (unsigned i = 0; i < matrix.rows; ++i) {
+        if (i > 0) os << ", ";
+        os << "<<";
+        for (unsigned j = 0; j < matrix.columns; ++j) {
+            if (j > 0) os << ", ";
+            os << matrix.values[static_cast<std::size_t>(i) * matrix.columns + j];
+        }
+        os << ">>";
+    }
+    os << ']';
+
+    return os;
+}
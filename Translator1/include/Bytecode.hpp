@@ -0,0 +1,96 @@
+#ifndef BYTECODE_HPP
+#define BYTECODE_HPP
+
+#include <cstdint>
+#include <vector>
+
+// Коды инструкций скомпилированной программы
+enum class Opcode : std::uint8_t {
+    // Стек и переменные; операнд — номер константы, вектора или переменной
+    PUSH_CONSTANT,
+    PUSH_VECTOR,
+    PUSH_VARIABLE,
+    POP,
+    READ,
+    WRITE,
+
+    // Арифметические операции
+    ADD,
+    SUB,
+    MUL,
+    DIV,
+    MOD,
+
+    // Векторные операции
+    VADD,
+    VSUB,
+    VMUL,
+    VDIV,
+    VMOD,
+    VDOT,
+    VCONCAT,
+    VLSHIFT,
+    VRSHIFT,
+    VSORT,
+    VFIND,
+    VUNIQ,
+    VGET,
+    VSET,
+    VGATHER,
+    VSCATTER,
+
+    // Матричные операции
+    MLOAD,
+    MMUL,
+    MTRANS,
+    MROW,
+    MCOL,
+
+    // Отношения
+    LESS,
+    GREATER,
+    LESS_EQUAL,
+    GREATER_EQUAL,
+    EQUAL,
+    NOT_EQUAL,
+
+    // Переходы; операнд — номер инструкции
+    JI,
+    JMP,
+    END,
+
+    // Составные инструкции, которые строит оптимизатор. INC и DEC прибавляют и вычитают 1 у переменной
+    // с номером операнда, J* снимают два числа и переходят на операнд, если отношение выполнено,
+    // VSET_VARIABLE и VSCATTER_VARIABLE — vset и vscatter с сохранением результата в переменную операнда
+    INC,
+    DEC,
+    JLESS,
+    JGREATER,
+    JLESS_EQUAL,
+    JGREATER_EQUAL,
+    JEQUAL,
+    JNOT_EQUAL,
+    VSET_VARIABLE,
+    VSCATTER_VARIABLE,
+
+    FAIL // ошибка, найденная при компиляции; операнд — номер сообщения
+};
+
+// Инструкция фиксированного размера: код и непосредственный операнд
+struct Instruction {
+    Opcode opcode;
+    std::uint32_t operand;
+
+    bool operator==(const Instruction &other) const = default;
+};
+
+static_assert(sizeof(Instruction) == 8);
+
+struct Bytecode {
+    std::vector<Instruction> code;
+    std::vector<unsigned> lines; // строка программы (с нуля) для каждой инструкции, только для сообщений об ошибках
+
+    bool operator==(const Bytecode &other) const = default;
+};
+
+#endif //BYTECODE_HPP
@@ -0,0 +1,35 @@
+#ifndef CONSTANTPOOL_HPP
+#define CONSTANTPOOL_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "InternTable.hpp"
+
+// Пул констант программы без повторов. Индекс константы выдаётся при первом добавлении
+// и больше не меняется; его и хранит лексема константы.
+class ConstantPool {
+    // Мультипликативное хеширование: соседние числа расходятся по разным ячейкам
+    struct Hash {
+        std::size_t operator()(unsigned value) const {
+            return static_cast<std::size_t>((value * 0x9E3779B97F4A7C15ULL) >> 32);
+        }
+    };
+
+    InternTable<unsigned, Hash> values;
+
+public:
+    unsigned intern(unsigned value) { return values.intern(value); } // индекс значения, при необходимости добавленного
+
+    [[nodiscard]] const unsigned *find(unsigned value) const { return values.find(value); } // nullptr, если значения нет
+
+    [[nodiscard]] unsigned value(unsigned index) const { return values[index]; }
+
+    [[nodiscard]] const std::vector<unsigned> &all() const { return values.all(); } // в порядке индексов
+
+    [[nodiscard]] std::size_t size() const { return values.size(); }
+
+    [[nodiscard]] bool empty() const { return values.empty(); }
+};
+
+#endif //CONSTANTPOOL_HPP
@@ -0,0 +1,40 @@
+#ifndef INCREMENTALLEXER_HPP
+#define INCREMENTALLEXER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "LexicalAnalyzer.hpp"
+
+// Текст программы вместе с результатом его анализа. После правки заново разбираются
+// только затронутые строки: язык построчный, и ни одна лексема не переходит на другую строку.
+class IncrementalLexer {
+    std::string text;
+    std::vector<std::size_t> lineStarts; // смещение начала каждой строки, строки нумеруются с 1
+    LexResult lexResult;
+
+    void indexLines();
+
+    // Разбор строк [firstLine, lastLine] нового текста вместо лексем [firstToken, lastToken)
+    void relex(unsigned firstLine, unsigned lastLine, std::size_t firstToken, std::size_t lastToken,
+               std::int64_t lineShift);
+
+public:
+    explicit IncrementalLexer(std::string source);
+
+    // Замена lineCount строк, начиная с firstLine, строками newLines. Завершающий перевод строки
+    // в newLines не порождает пустой строки; пустой newLines удаляет строки.
+    // Имена, которые больше не встречаются, остаются в таблице, чтобы номера остальных не менялись
+    void edit(unsigned firstLine, unsigned lineCount, std::string_view newLines);
+
+    [[nodiscard]] const LexResult &result() const { return lexResult; }
+
+    [[nodiscard]] std::string_view source() const { return text; }
+
+    [[nodiscard]] unsigned lineCount() const { return static_cast<unsigned>(lineStarts.size()); }
+};
+
+#endif //INCREMENTALLEXER_HPP
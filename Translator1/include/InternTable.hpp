@@ -0,0 +1,73 @@
+#ifndef INTERNTABLE_HPP
+#define INTERNTABLE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+// Ключи без повторов с номерами в порядке добавления: ключ -> номер через хеш-таблицу
+// с открытой адресацией, номер -> ключ через плотный массив. Номер ключа не меняется.
+template<typename Key, typename Hash>
+class InternTable {
+    static constexpr unsigned emptySlot = ~0U;
+    static constexpr std::size_t initialCapacity = 16; // степень двойки
+
+    std::vector<Key> keys; // ключ по номеру
+    std::vector<unsigned> slots; // номера ключей, emptySlot — свободная ячейка
+
+    [[nodiscard]] std::size_t findSlot(const Key &key) const {
+        const std::size_t mask = slots.size() - 1;
+        std::size_t slot = Hash{}(key) & mask;
+
+        // Линейное пробирование: заполненность не выше половины, свободная ячейка всегда найдётся
+        while (slots[slot] != emptySlot && keys[slots[slot]] != key)
+            slot = (slot + 1) & mask;
+
+        return slot;
+    }
+
+    void grow() {
+        slots.assign(slots.empty() ? initialCapacity : slots.size() * 2, emptySlot);
+
+        for (unsigned id = 0; id < keys.size(); ++id)
+            slots[findSlot(keys[id])] = id;
+    }
+
+public:
+    // Номер ключа, при необходимости добавленного. В таблицу записывается store(key):
+    // так таблица имён подменяет временную строку своей копией
+    template<typename Store = std::identity>
+    unsigned intern(const Key &key, Store store = {}) {
+        if ((keys.size() + 1) * 2 > slots.size())
+            grow();
+
+        const std::size_t slot = findSlot(key);
+        if (slots[slot] != emptySlot)
+            return slots[slot];
+
+        const auto id = static_cast<unsigned>(keys.size());
+        keys.push_back(store(key));
+        slots[slot] = id;
+
+        return id;
+    }
+
+    [[nodiscard]] const unsigned *find(const Key &key) const { // nullptr, если ключа нет
+        if (slots.empty())
+            return nullptr;
+
+        const std::size_t slot = findSlot(key);
+
+        return slots[slot] == emptySlot ? nullptr : &slots[slot];
+    }
+
+    [[nodiscard]] const Key &operator[](unsigned id) const { return keys[id]; }
+
+    [[nodiscard]] const std::vector<Key> &all() const { return keys; } // в порядке номеров
+
+    [[nodiscard]] std::size_t size() const { return keys.size(); }
+
+    [[nodiscard]] bool empty() const { return keys.empty(); }
+};
+
+#endif //INTERNTABLE_HPP
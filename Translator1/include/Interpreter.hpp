@@ -1,21 +1,95 @@
 #ifndef INTERPRETER_HPP
 #define INTERPRETER_HPP
 
-#include <stack>
 #include <vector>
-#include <map>
 #include <sstream>
 #include <ranges>
 
 #include "../../DArray/include/DArray.hpp"
+#include "../../DArray/include/Matrix.hpp"
+#include "Bytecode.hpp"
+#include "LexicalAnalyzer.hpp"
+#include "Optimizer.hpp"
+#include "Value.hpp"
+#include "ValueHeap.hpp"
+
+// Вычисляемый goto (адреса меток) — расширение GCC и Clang; -DRGR4_COMPUTED_GOTO=0 отключает его
+#ifndef RGR4_COMPUTED_GOTO
+#if defined(__GNUC__)
+#define RGR4_COMPUTED_GOTO 1
+#else
+#define RGR4_COMPUTED_GOTO 0
+#endif
+#endif
 
 class Interpreter {
-    std::stack<std::variant<int, DArray>> stack;
-    std::map<std::string, std::variant<int, DArray>> variables;
+    static constexpr std::size_t initialStackCapacity = 1024;
+
+    ValueHeap heap;
+    std::vector<Value> stack; // вершина — последний элемент
+    SymbolTable variableNames; // имя переменной по номеру слота; номера совпадают с таблицей имён лексического анализатора
+    std::vector<Value> variables; // значение по номеру слота, пустое — переменной ещё не присваивали
     std::vector<std::string> program;
-    std::vector<DArray> vectors;
-    size_t currentLine;
-    size_t vectorIndex;
+    std::vector<Value> vectors; // векторы программы; таблица держит ссылку на каждый
+    std::vector<Value> constants; // константы программы: пул лексического анализатора и длинные числа
+    std::vector<std::size_t> lineConstants; // индекс константы операнда push по номеру строки
+    std::vector<std::string> compileErrors; // сообщения инструкций FAIL
+    Bytecode bytecode;
+
+    static constexpr std::size_t noConstant = ~std::size_t{0};
+
+    // Перевод текста программы в инструкции; false, если в программе есть неизвестные команды
+    bool compile();
+
+    void require(std::size_t count) const; // в стеке не меньше count значений
+
+    template<typename T>
+    T pop(); // бросает std::runtime_error, если на вершине значение другого вида
+
+    template<typename T>
+    void push(T object);
+
+    template<typename T, typename Operation>
+    void binary(Operation operation); // a b -> operation(a, b)
+
+    void drop(); // снимает вершину стека вместе с её ссылкой
+
+    // Вектор, который инструкция может изменить на месте: кроме стека на него ссылается разве что
+    // переменная, в которую инструкция *_VARIABLE сохранит результат. nullptr — менять нужно копию
+    DArray *unsharedVector(Instruction instruction, Value vector);
+
+    void storeResult(Instruction instruction); // у *_VARIABLE переносит вершину стека в переменную операнда
+
+    void loadVector(const std::vector<unsigned> &vectorData);
+
+    void loadVectors(const std::vector<std::vector<unsigned>> &vectorsData);
+
+    void loadNames(const SymbolTable &nameTable); // имена получают те же номера слотов, что и в таблице
+
+    // Запоминает номер в пуле для константы, стоящей после push в той же строке
+    void matchPooledConstant(const Lexeme &previous, const Lexeme &lexeme, const ConstantPool &pool,
+                             std::vector<std::size_t> &pooled) const;
+
+    // Константы из пула лексического анализатора; остальные числа разбираются при компиляции
+    void loadConstants(const ConstantPool *pool, const std::vector<std::size_t> &pooled);
+
+    static int toElement(const BigNat &value); // натуральное число как элемент вектора
+
+    static BigNat fromElement(int value); // элемент вектора как натуральное число
+
+public:
+    // Выбор обработчика инструкции: общий switch или переход по таблице адресов обработчиков
+    enum class Dispatch { SWITCH, THREADED };
+
+    // С вершиной стека в регистре switch по замерам interpreter_benchmark быстрее перехода по таблице
+    // (0.7–0.9 времени threaded), поэтому THREADED выбирается только явно
+    static constexpr Dispatch defaultDispatch = Dispatch::SWITCH;
+
+private:
+    template<Dispatch dispatch>
+    void run();
+
+    void executeSlow(Instruction instruction); // ввод, вывод, векторы и матрицы: весь стек лежит в stack
 
 public:
     explicit Interpreter(const std::vector<std::string> &programLines);
@@ -23,12 +97,30 @@ public:
     explicit Interpreter(const std::vector<std::string> &programLines,
                          const std::vector<std::vector<unsigned>> &vectorsData);
 
-    void execute();
+    // Векторы и константы берутся из результата лексического анализа
+    Interpreter(const std::vector<std::string> &programLines, const LexResult &lexResult);
+
+    // Загрузка одновременно с лексическим анализом: лексемы берутся из lexer.next() по одной.
+    // Из потока загружаются только векторы и константы из пула; команды compile() по-прежнему разбирает
+    // из programLines при execute(), поэтому это должен быть тот же текст, что передан lexer.start().
+    // Байт-код получается тем же, что и при загрузке по LexResult
+    Interpreter(const std::vector<std::string> &programLines, Lexer &lexer);
+
+    // THREADED без поддержки компилятора выполняется через switch. optimize = false — байт-код выполняется
+    // без оптимизатора; так проверяется, что он не меняет вывод и сообщения об ошибках
+    void execute(Dispatch dispatch = defaultDispatch, bool optimize = true);
+
+    [[nodiscard]] const Bytecode &getBytecode() const { return bytecode; } // пуст до execute()
 
     void printStack() const;
 
     void printVariables() const;
 
+    // Бюджет памяти для векторов, сверх которого блоки вытесняются во временный файл
+    static void setMemoryBudget(std::size_t bytes);
+
+    [[nodiscard]] static std::size_t getMemoryBudget();
+
     static std::vector<std::string> readFileIntoVector(const std::string &filePath);
 };
 
@@ -0,0 +1,136 @@
+#ifndef LEXEME_HPP
+#define LEXEME_HPP
+
+// список кодов лексем
+enum class LexemeCodes {
+    // Операции сравнения
+    EQUAL = 1,           // Равно
+    NOT_EQUAL = 2,       // Не равно
+    LESS = 3,           // Меньше
+    GREATER = 4,        // Больше
+    LESS_EQUAL = 5,     // Меньше либо равно
+    GREATER_EQUAL = 6,  // Больше либо равно
+
+    // Базовые операции
+    PUSH = 995,
+    POP = 996,
+    ARITHMETIC_OPERATION = 997,
+    RELATION = 998,
+    JMP = 999,
+    JI = 1000,
+    READ = 1001,
+    WRITE = 1002,
+    END = 1003,
+    COMMENT = 1004,
+    ERROR = 1005,
+    END_MARKER = 1006,
+
+    // Арифметические операции
+    ADD = 1007,
+    SUB = 1008,
+    MUL = 1009,
+    DIV = 1010,
+    MOD = 1011,
+
+    // Переменные и константы
+    VARIABLE = 1018,
+    CONSTANT = 1019,
+
+    // Векторные операции и разделители
+    VECTOR_START = 1020,
+    COMMA = 1021,
+    VECTOR_END = 1022,
+    VADD = 1023,
+    VSUB = 1024,
+    VMUL = 1025,
+    VDIV = 1026,
+    VMOD = 1027,
+    VDOT = 1028,
+    VCONCAT = 1029,
+    VLSHIFT = 1030,
+    VRSHIFT = 1031,
+
+    // Матричные операции
+    MLOAD = 1032,
+    MMUL = 1033,
+    MTRANS = 1034,
+    MROW = 1035,
+    MCOL = 1036,
+
+    // Сортировка, поиск и удаление повторов
+    VSORT = 1037,
+    VFIND = 1038,
+    VUNIQ = 1039,
+
+    // Доступ к элементам по индексам
+    VGET = 1040,
+    VSET = 1041,
+    VGATHER = 1042,
+    VSCATTER = 1043,
+
+    // Векторный литерал целиком; значение — номер в таблице векторов
+    VECTOR = 1044
+};
+
+// список лексем
+enum class LexemeClass {
+    PUSH = static_cast<int>(LexemeCodes::PUSH),
+    POP = static_cast<int>(LexemeCodes::POP),
+    ARITHMETIC_OPERATION = static_cast<int>(LexemeCodes::ARITHMETIC_OPERATION),
+    RELATION = static_cast<int>(LexemeCodes::RELATION),
+    JMP = static_cast<int>(LexemeCodes::JMP),
+    JI = static_cast<int>(LexemeCodes::JI),
+    READ = static_cast<int>(LexemeCodes::READ),
+    WRITE = static_cast<int>(LexemeCodes::WRITE),
+    END = static_cast<int>(LexemeCodes::END),
+    COMMENT = static_cast<int>(LexemeCodes::COMMENT),
+    ERROR = static_cast<int>(LexemeCodes::ERROR),
+    END_MARKER = static_cast<int>(LexemeCodes::END_MARKER),
+    ADD = static_cast<int>(LexemeCodes::ADD),
+    SUB = static_cast<int>(LexemeCodes::SUB),
+    MUL = static_cast<int>(LexemeCodes::MUL),
+    DIV = static_cast<int>(LexemeCodes::DIV),
+    MOD = static_cast<int>(LexemeCodes::MOD),
+    LESS = static_cast<int>(LexemeCodes::LESS),
+    GREATER = static_cast<int>(LexemeCodes::GREATER),
+    LESS_EQUAL = static_cast<int>(LexemeCodes::LESS_EQUAL),
+    GREATER_EQUAL = static_cast<int>(LexemeCodes::GREATER_EQUAL),
+    EQUAL = static_cast<int>(LexemeCodes::EQUAL),
+    NOT_EQUAL = static_cast<int>(LexemeCodes::NOT_EQUAL),
+    VARIABLE = static_cast<int>(LexemeCodes::VARIABLE),
+    CONSTANT = static_cast<int>(LexemeCodes::CONSTANT),
+    VECTOR_START = static_cast<int>(LexemeCodes::VECTOR_START),
+    COMMA = static_cast<int>(LexemeCodes::COMMA),
+    VECTOR_END = static_cast<int>(LexemeCodes::VECTOR_END),
+    VADD = static_cast<int>(LexemeCodes::VADD),
+    VSUB = static_cast<int>(LexemeCodes::VSUB),
+    VMUL = static_cast<int>(LexemeCodes::VMUL),
+    VDIV = static_cast<int>(LexemeCodes::VDIV),
+    VMOD = static_cast<int>(LexemeCodes::VMOD),
+    VDOT = static_cast<int>(LexemeCodes::VDOT),
+    VCONCAT = static_cast<int>(LexemeCodes::VCONCAT),
+    VLSHIFT = static_cast<int>(LexemeCodes::VLSHIFT),
+    VRSHIFT = static_cast<int>(LexemeCodes::VRSHIFT),
+    MLOAD = static_cast<int>(LexemeCodes::MLOAD),
+    MMUL = static_cast<int>(LexemeCodes::MMUL),
+    MTRANS = static_cast<int>(LexemeCodes::MTRANS),
+    MROW = static_cast<int>(LexemeCodes::MROW),
+    MCOL = static_cast<int>(LexemeCodes::MCOL),
+    VSORT = static_cast<int>(LexemeCodes::VSORT),
+    VFIND = static_cast<int>(LexemeCodes::VFIND),
+    VUNIQ = static_cast<int>(LexemeCodes::VUNIQ),
+    VGET = static_cast<int>(LexemeCodes::VGET),
+    VSET = static_cast<int>(LexemeCodes::VSET),
+    VGATHER = static_cast<int>(LexemeCodes::VGATHER),
+    VSCATTER = static_cast<int>(LexemeCodes::VSCATTER),
+    VECTOR = static_cast<int>(LexemeCodes::VECTOR),
+};
+
+// структура для представления лексемы
+struct Lexeme {
+    LexemeClass lexemeClass;
+    unsigned value;
+    unsigned lineNumber;
+};
+
+#endif //LEXEME_HPP
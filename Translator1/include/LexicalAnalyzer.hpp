@@ -2,109 +2,18 @@
 #define LEXICALANALYZER_HPP
 
 #include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <vector>
-#include <fstream>
-#include <map>
-#include <optional>
-#include <set>
-#include <unordered_map>
-#include <variant>
-
-extern std::map<std::string, unsigned> nameTable;
-extern std::ifstream file;
-extern std::vector<std::vector<unsigned>> vectors;
-extern std::vector<unsigned> currentVector;
-
-// список кодов лексем
-enum class LexemeCodes {
-    // Операции сравнения
-    EQUAL = 1,           // Равно
-    NOT_EQUAL = 2,       // Не равно
-    LESS = 3,           // Меньше
-    GREATER = 4,        // Больше
-    LESS_EQUAL = 5,     // Меньше либо равно
-    GREATER_EQUAL = 6,  // Больше либо равно
-
-    // Базовые операции
-    PUSH = 995,
-    POP = 996,
-    ARITHMETIC_OPERATION = 997,
-    RELATION = 998,
-    JMP = 999,
-    JI = 1000,
-    READ = 1001,
-    WRITE = 1002,
-    END = 1003,
-    COMMENT = 1004,
-    ERROR = 1005,
-    END_MARKER = 1006,
-
-    // Арифметические операции
-    ADD = 1007,
-    SUB = 1008,
-    MUL = 1009,
-    DIV = 1010,
-    MOD = 1011,
-
-    // Переменные и константы
-    VARIABLE = 1018,
-    CONSTANT = 1019,
-
-    // Векторные операции и разделители
-    VECTOR_START = 1020,
-    COMMA = 1021,
-    VECTOR_END = 1022,
-    VADD = 1023,
-    VSUB = 1024,
-    VMUL = 1025,
-    VDIV = 1026,
-    VMOD = 1027,
-    VDOT = 1028,
-    VCONCAT = 1029,
-    VLSHIFT = 1030,
-    VRSHIFT = 1031
-};
+#include <memory>
+#include <string>
+#include <string_view>
 
-// список лексем
-enum class LexemeClass {
-    PUSH = static_cast<int>(LexemeCodes::PUSH),
-    POP = static_cast<int>(LexemeCodes::POP),
-    ARITHMETIC_OPERATION = static_cast<int>(LexemeCodes::ARITHMETIC_OPERATION),
-    RELATION = static_cast<int>(LexemeCodes::RELATION),
-    JMP = static_cast<int>(LexemeCodes::JMP),
-    JI = static_cast<int>(LexemeCodes::JI),
-    READ = static_cast<int>(LexemeCodes::READ),
-    WRITE = static_cast<int>(LexemeCodes::WRITE),
-    END = static_cast<int>(LexemeCodes::END),
-    COMMENT = static_cast<int>(LexemeCodes::COMMENT),
-    ERROR = static_cast<int>(LexemeCodes::ERROR),
-    END_MARKER = static_cast<int>(LexemeCodes::END_MARKER),
-    ADD = static_cast<int>(LexemeCodes::ADD),
-    SUB = static_cast<int>(LexemeCodes::SUB),
-    MUL = static_cast<int>(LexemeCodes::MUL),
-    DIV = static_cast<int>(LexemeCodes::DIV),
-    MOD = static_cast<int>(LexemeCodes::MOD),
-    LESS = static_cast<int>(LexemeCodes::LESS),
-    GREATER = static_cast<int>(LexemeCodes::GREATER),
-    LESS_EQUAL = static_cast<int>(LexemeCodes::LESS_EQUAL),
-    GREATER_EQUAL = static_cast<int>(LexemeCodes::GREATER_EQUAL),
-    EQUAL = static_cast<int>(LexemeCodes::EQUAL),
-    NOT_EQUAL = static_cast<int>(LexemeCodes::NOT_EQUAL),
-    VARIABLE = static_cast<int>(LexemeCodes::VARIABLE),
-    CONSTANT = static_cast<int>(LexemeCodes::CONSTANT),
-    VECTOR_START = static_cast<int>(LexemeCodes::VECTOR_START),
-    COMMA = static_cast<int>(LexemeCodes::COMMA),
-    VECTOR_END = static_cast<int>(LexemeCodes::VECTOR_END),
-    VADD = static_cast<int>(LexemeCodes::VADD),
-    VSUB = static_cast<int>(LexemeCodes::VSUB),
-    VMUL = static_cast<int>(LexemeCodes::VMUL),
-    VDIV = static_cast<int>(LexemeCodes::VDIV),
-    VMOD = static_cast<int>(LexemeCodes::VMOD),
-    VDOT = static_cast<int>(LexemeCodes::VDOT),
-    VCONCAT = static_cast<int>(LexemeCodes::VCONCAT),
-    VLSHIFT = static_cast<int>(LexemeCodes::VLSHIFT),
-    VRSHIFT = static_cast<int>(LexemeCodes::VRSHIFT),
-};
+#include "ConstantPool.hpp"
+#include "SourceBuffer.hpp"
+#include "SymbolTable.hpp"
+#include "TokenStream.hpp"
 
 // список символьных лексем
 enum class SymbolicTokenClass {
@@ -124,299 +33,296 @@ struct SymbolicToken {
     unsigned value;
 };
 
-// структура для представления лексемы
-struct Lexeme {
-    LexemeClass lexemeClass;
-    unsigned value;
-    unsigned lineNumber;
+// сообщение анализатора об ошибке в тексте программы
+struct Diagnostic {
+    unsigned line; // 0 — сообщение не относится к строке (например, файл не открылся)
+    std::string message; // без номера строки: при правке текста строка сообщения сдвигается
+
+    [[nodiscard]] std::string text() const {
+        return line == 0 ? message : "Ошибка в строке " + std::to_string(line) + ": " + message;
+    }
+
+    bool operator==(const Diagnostic &other) const = default;
 };
 
-inline std::vector<Lexeme> lexemes;
-inline std::set<unsigned> constantTable;
-
-inline unsigned numberRegister = 0; // регистр числа
-inline unsigned short classRegister; // хранит класс лексемы
-inline char relationRegister = '\0'; // регистр отношения
-inline std::string variableRegister; // регистр имени переменной
-inline unsigned lineNumber = 1; // текущий номер строки программы
-inline bool constantFlag = false; // флаг, указывающий на константу
-inline short detectionRegister; // регистр обнаружения
-inline unsigned pointerRegister = 0; // регистр указателя
-
-inline std::unordered_map<LexemeClass, std::string> operationMap = {
-    {LexemeClass::ADD, "+"},
-    {LexemeClass::SUB, "-"},
-    {LexemeClass::MUL, "*"},
-    {LexemeClass::DIV, "/"},
-    {LexemeClass::MOD, "%"},
-    {LexemeClass::LESS, "<"},
-    {LexemeClass::GREATER, ">"},
-    {LexemeClass::LESS_EQUAL, "<="},
-    {LexemeClass::GREATER_EQUAL, ">="},
-    {LexemeClass::EQUAL, "=="},
-    {LexemeClass::NOT_EQUAL, "!="}
+// результат лексического анализа одной программы
+struct LexResult {
+    TokenStream lexemes;
+    ConstantPool constantTable; // константы-операнды push в порядке первого появления
+    SymbolTable nameTable;
+    std::vector<std::vector<unsigned>> vectors;
+    // Сообщения в порядке строк. Анализатор их не печатает: несколько анализаторов в разных потоках
+    // не перемешивают вывод, и вызывающий знает, к какой программе относится сообщение
+    std::vector<Diagnostic> diagnostics;
+    std::shared_ptr<const SourceBuffer> source; // текст или файл кэша, на который ссылаются имена; пусто, если им владеет вызывающий
 };
 
-void addNameToTable(const std::string &name);
+short processRelation(char first, char second);
 
-void addConstant(unsigned short &pointerRegister, unsigned numberRegister, bool constantFlag);
+// Значение константы-операнда push — её индекс в constantTable; операнд jmp и ji в таблицу не входит,
+// и значение его лексемы — сам номер строки
+inline bool isPooledConstant(LexemeClass previousClass, LexemeClass lexemeClass) {
+    return lexemeClass == LexemeClass::CONSTANT && previousClass == LexemeClass::PUSH;
+}
 
-extern void createLexeme(LexemeClass classRegister, unsigned pointerRegister, unsigned numberRegister,
-                         unsigned relationRegister,
-                         unsigned lineNumber);
+// previousClass — класс предыдущей лексемы, по нему различаются значения констант
+std::string getLexemeValueString(const LexResult &result, LexemeClass lexemeClass, unsigned value,
+                                 LexemeClass previousClass);
 
-SymbolicToken transliterator(int ch);
+constexpr static unsigned short numberStates = 27; // Количество состояний
+constexpr static unsigned short numberClass = 12; // Количество символьных лексем
 
-inline unsigned relationTable[4][4] = {
-    {0, 0, 0, 0},
-    {static_cast<unsigned>(LexemeCodes::NOT_EQUAL), 0, 0, 0},
-    {static_cast<unsigned>(LexemeCodes::LESS_EQUAL), 0, 0, 0},
-    {static_cast<unsigned>(LexemeCodes::GREATER_EQUAL), 0, 0, 0}
-};
+// Лексический анализатор. Всё состояние разбора принадлежит объекту, поэтому
+// несколько анализаторов могут работать одновременно в разных потоках.
+class Lexer {
+public:
+    using Procedure = States (Lexer::*)();
 
-short processRelation(char first, char second);
+    static constexpr std::size_t parallelThreshold = std::size_t{1} << 20; // меньшие тексты разбираются в одном потоке
+    static constexpr unsigned maxLexThreads = 16;
 
-inline SymbolicToken globalSymbol;
-inline std::string globalComment;
+    // Анализ текста, уже находящегося в памяти. Имена в результате могут ссылаться на source,
+    // поэтому текст должен жить не меньше результата
+    LexResult parse(std::string_view source);
 
-using Procedure = States(*)();
-using VariantType = std::variant<unsigned long, SymbolicTokenClass>;
-extern std::vector<std::tuple<unsigned long, char, std::optional<unsigned long>, Procedure>> vectorOfAlternatives;
-extern std::map<char, VariantType> initialMap;
-inline std::vector<std::string> variables;
+    // Разбор по частям в нескольких потоках; результат совпадает с parse(). 0 — по числу ядер
+    static LexResult parseParallel(std::string_view source, unsigned threadCount = 0);
 
-void addVariable();
+    // Потоковый разбор: start() задаёт текст, next() выдаёт лексемы по одной по мере продвижения
+    // автомата и возвращает false в конце текста. Лексемы не накапливаются, таблицы имён,
+    // констант и векторов пополняются как обычно и доступны через tables()
+    void start(std::string_view source);
 
-std::string getLexemeValueString(LexemeClass lexemeClass, unsigned value);
+    bool next(Lexeme &lexeme);
 
-States A1();
+    [[nodiscard]] const LexResult &tables() const { return result; }
 
-States A1a();
+private:
+    friend class IncrementalLexer; // разбирает отдельные строки через parseRange
 
-States A1b();
+    // Переходы таблицы состояний: по одному на обработчик
+    enum class Transition : std::uint8_t {
+        error,
+        A1, A1a, A1b, A2, A2a, A2b, A2c, A2d, A2e, A2f, B1a, C1, C1a, C1e, C1f, C1g, C1h, D1a, EXIT1, EXIT2,
+        EXIT3, EXIT4, F1, F2, F3, G1a, G1b, H1a, H1b, I1, I1a, I2, I2a, I2b, I2c, I2d, J1, M1, V1, V2,
+        handleVectorStart
+    };
 
-States A2();
+    using TransitionTable = std::array<std::array<Transition, numberClass>, numberStates>;
 
-States A2a();
+    // Ключевое слово языка и переход автомата после его последней буквы
+    struct Keyword {
+        std::string_view text;
+        LexemeClass lexemeClass;
+        Procedure procedure;
+    };
 
-States A2b();
+    LexResult result;
+    std::vector<unsigned> currentVector;
+    std::deque<Lexeme> pending; // разобранные, но ещё не выданные next() лексемы
+    bool streaming = false; // лексемы идут в pending, а не в result
+    States streamState = States::states_A1;
 
-States A2c();
+    unsigned numberRegister = 0; // регистр числа
+    unsigned short classRegister = 0; // хранит класс лексемы
+    char relationRegister = '\0'; // регистр отношения
+    std::string variableRegister; // регистр имени переменной
+    unsigned lineNumber = 1; // текущий номер строки программы
+    bool constantFlag = false; // флаг, указывающий на константу
+    short detectionRegister = 0; // регистр обнаружения: узел дерева ключевых слов
+    unsigned pointerRegister = 0; // регистр указателя
+    bool inComment = false; // внутри комментария
+    const char *sourceCursor = nullptr; // следующий непрочитанный символ текста программы
+    const char *sourceEnd = nullptr; // конец текста программы
+    const char *identifierStart = nullptr; // начало текущего имени в тексте программы
 
-States A2d();
+    SymbolicToken globalSymbol{};
 
-States A2e();
+    static const Keyword keywords[]; // по ним при компиляции строится префиксное дерево
 
-States A2f();
+    static constexpr short noKeyword = -1; // узел дерева, из которого нет продолжений
 
-States B1a();
+    // Переход по дереву из узла node (корень — 0); возвращает ключевое слово, если оно здесь заканчивается
+    static const Keyword *nextKeyword(short &node, char letter);
 
-States B1b();
+    static const Keyword *findKeyword(std::string_view name);
 
-States C1();
+    static consteval TransitionTable initializeTable();
 
-States C1a();
+    States dispatch(Transition transition);
 
-States C1b();
+    void reset();
 
-States C1c();
+    LexResult parseRange(std::string_view source, States startState, unsigned firstLine, bool lastChunk);
 
-States C1d();
+    // Один шаг автомата: символ, серия пробелов или тело комментария. false — разбор окончен
+    bool step(States &currentState, bool processEnd);
 
-States C1e();
+    static bool onlyBlankLines(std::string_view text);
 
-States C1f();
+    void addNameToTable(std::string_view name);
 
-States C1g();
+    void addConstant(unsigned numberRegister, bool constantFlag);
 
-States C1h();
+    void createLexeme(LexemeClass classRegister, unsigned pointerRegister, unsigned numberRegister,
+                      unsigned relationRegister, unsigned lineNumber);
 
-States D1a();
+    SymbolicToken transliterator(int ch);
 
-States E1a();
+    void addVariable();
 
-States E2a();
+    States errorTransition();
 
-States E2b();
+    // Дочитывает серию цифр, начатую последним символом, и добавляет её к numberRegister.
+    // false — значение не помещается в unsigned
+    bool readNumber();
 
-States E3a();
+    States numberOverflow(); // переполнение числа — лексическая ошибка
 
-States F1();
+    void report(unsigned line, std::string message); // сообщение попадает в result.diagnostics
 
-States F2();
+    States A1();
 
-States F3();
+    States A1a();
 
-States G1a();
+    States A1b();
 
-States G1b();
+    States A2();
 
-States H1a();
+    States A2a();
 
-States H1b();
+    States A2b();
 
-States I1();
+    States A2c();
 
-States I1a();
+    States A2d();
 
-States I2();
+    States A2e();
 
-States I2a();
+    States A2f();
 
-States I2b();
+    States B1a();
 
-States I2c();
+    States C1();
 
-States I2d();
+    States C1a();
 
-States J1();
+    States C1b();
 
-States M1();
+    States C1c();
 
-States V1();
+    States C1d();
 
-States V2();
+    States C1e();
 
-States handleVCommand();
+    States C1f();
 
-States handleVectorStart();
+    States C1g();
 
-States handleVSubCommand();
+    States C1h();
 
-States handleVMulCommand();
+    States D1a();
 
-States handleVDivCommand();
+    States E1a();
 
-States handleVModCommand();
+    States E2a();
 
-States handleVDotCommand();
+    States E2b();
 
-States handleVConcatCommand();
+    States E3a();
 
-States handleVLShiftCommand();
+    States F1();
 
-States handleVRShiftCommand();
+    States F2();
 
-States EXIT1();
+    States F3();
 
-States EXIT2();
+    States G1a();
 
-States EXIT3();
+    States G1b();
 
-States EXIT4();
+    States H1a();
 
-States ERROR1(const unsigned &lineNumber);
+    States H1b();
 
-constexpr static unsigned short numberStates = 27; // Количество состояний
-constexpr static unsigned short numberClass = 12; // Количество символьных лексем
+    States I1();
 
-using functionPointer = States (*)();
-using TransitionTable = std::array<std::array<functionPointer, numberClass>, numberStates>;
-
-// Вектор альтернатив
-inline std::vector<std::tuple<unsigned long, char, std::optional<unsigned long>, Procedure>> vectorOfAlternatives = {
-    {1, 'n', std::nullopt, B1b},
-    {2, 'd', std::nullopt, C1b},
-
-    {3, 'i', std::make_optional(4UL), E2a},
-
-    {4, 'm', std::nullopt, B1b},
-    {5, 'p', std::nullopt, E2b},
-
-    {6, 'o', std::make_optional(8UL), B1b},
-    {7, 'p', std::nullopt, E3a},
-
-    {8, 'u', std::nullopt, B1b},
-    {9, 's', std::nullopt, B1b},
-    {10, 'h', std::nullopt, E1a},
-
-    {11, 'e', std::nullopt, B1b},
-    {12, 'a', std::nullopt, B1b},
-    {13, 'd', std::nullopt, C1c},
-
-    {14, 'r', std::nullopt, B1b},
-    {15, 'i', std::nullopt, B1b},
-    {16, 't', std::nullopt, B1b},
-    {17, 'e', std::nullopt, C1d},
-
-    {18, 'a', std::make_optional(21UL), B1b},
-    {19, 'd', std::nullopt, B1b},
-    {20, 'd', std::nullopt, handleVCommand},
-
-    {21, 's', std::make_optional(24UL), B1b},
-    {22, 'u', std::nullopt, B1b},
-    {23, 'b', std::nullopt, handleVSubCommand},
-
-    {24, 'm', std::make_optional(27UL), B1b},
-    {25, 'u', std::make_optional(31UL), B1b},
-    {26, 'l', std::nullopt, handleVMulCommand},
-
-    {27, 'd', std::make_optional(30UL), B1b},
-    {28, 'i', std::nullopt, B1b},
-    {29, 'v', std::nullopt, handleVDivCommand},
-
-    {30, 'm', std::make_optional(33UL), B1b},
-    {31, 'o', std::nullopt, B1b},
-    {32, 'd', std::nullopt, handleVModCommand},
-
-    {33, 'd', std::make_optional(36UL), B1b},
-    {34, 'o', std::nullopt, B1b},
-    {35, 't', std::nullopt, handleVDotCommand},
-
-    {36, 'c', std::make_optional(42UL), B1b},
-    {37, 'o', std::nullopt, B1b},
-    {38, 'n', std::nullopt, B1b},
-    {39, 'c', std::nullopt, B1b},
-    {40, 'a', std::nullopt, B1b},
-    {41, 't', std::nullopt, handleVConcatCommand},
-
-    {42, 'l', std::make_optional(48UL), B1b},
-    {43, 's', std::nullopt, B1b},
-    {44, 'h', std::nullopt, B1b},
-    {45, 'i', std::nullopt, B1b},
-    {46, 'f', std::nullopt, B1b},
-    {47, 't', std::nullopt, handleVLShiftCommand},
-
-    {48, 'r', std::nullopt, B1b},
-    {49, 's', std::nullopt, B1b},
-    {50, 'h', std::nullopt, B1b},
-    {51, 'i', std::nullopt, B1b},
-    {52, 'f', std::nullopt, B1b},
-    {53, 't', std::nullopt, handleVRShiftCommand}
-};
+    States I1a();
 
-// Начальный вектор
-inline std::map<char, VariantType> initialMap{
-    {'a', VariantType{SymbolicTokenClass::ERROR}},
-    {'b', VariantType{SymbolicTokenClass::ERROR}},
-    {'c', VariantType{SymbolicTokenClass::ERROR}},
-    {'d', VariantType{SymbolicTokenClass::ERROR}},
-    {'e', VariantType{static_cast<unsigned long>(1)}},
-    {'f', VariantType{SymbolicTokenClass::ERROR}},
-    {'g', VariantType{SymbolicTokenClass::ERROR}},
-    {'h', VariantType{SymbolicTokenClass::ERROR}},
-    {'i', VariantType{SymbolicTokenClass::ERROR}},
-    {'j', VariantType{static_cast<unsigned long>(3)}},
-    {'k', VariantType{SymbolicTokenClass::ERROR}},
-    {'l', VariantType{SymbolicTokenClass::ERROR}},
-    {'m', VariantType{SymbolicTokenClass::ERROR}},
-    {'n', VariantType{SymbolicTokenClass::ERROR}},
-    {'o', VariantType{SymbolicTokenClass::ERROR}},
-    {'p', VariantType{static_cast<unsigned long>(6)}},
-    {'q', VariantType{SymbolicTokenClass::ERROR}},
-    {'r', VariantType{static_cast<unsigned long>(11)}},
-    {'s', VariantType{SymbolicTokenClass::ERROR}},
-    {'t', VariantType{SymbolicTokenClass::ERROR}},
-    {'u', VariantType{SymbolicTokenClass::ERROR}},
-    {'v', VariantType{static_cast<unsigned long>(18)}},
-    {'w', VariantType{static_cast<unsigned long>(14)}},
-    {'x', VariantType{SymbolicTokenClass::ERROR}},
-    {'y', VariantType{SymbolicTokenClass::ERROR}},
-    {'z', VariantType{SymbolicTokenClass::ERROR}}
-};
+    States I2();
+
+    States I2a();
+
+    States I2b();
+
+    States I2c();
+
+    States I2d();
+
+    States J1();
+
+    States M1();
+
+    States V1();
+
+    States V2();
+
+    States handleVCommand();
+
+    States handleVectorStart();
+
+    States handleVSubCommand();
 
-TransitionTable initializeTable();
+    States handleVMulCommand();
+
+    States handleVDivCommand();
+
+    States handleVModCommand();
+
+    States handleVDotCommand();
+
+    States handleVConcatCommand();
+
+    States handleVLShiftCommand();
+
+    States handleVRShiftCommand();
+
+    States handleMLoadCommand();
+
+    States handleMMulCommand();
+
+    States handleMTransCommand();
+
+    States handleMRowCommand();
+
+    States handleMColCommand();
+
+    States handleVSortCommand();
+
+    States handleVFindCommand();
+
+    States handleVUniqCommand();
+
+    States handleVGetCommand();
+
+    States handleVSetCommand();
+
+    States handleVGatherCommand();
+
+    States handleVScatterCommand();
+
+    States EXIT1();
+
+    States EXIT2();
+
+    States EXIT3();
+
+    States EXIT4();
+
+    States ERROR1(const unsigned &lineNumber);
+};
 
-void parse(const std::string &filePath);
+// Если cacheDirectory не пуст, результат берётся из кэша лексем и сохраняется в него
+LexResult parse(const std::string &filePath, const std::string &cacheDirectory = "");
 
-#endif //LEXICALANALYZER_HPP
\ No newline at end of file
+#endif //LEXICALANALYZER_HPP
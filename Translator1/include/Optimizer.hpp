@@ -0,0 +1,54 @@
+#ifndef OPTIMIZER_HPP
+#define OPTIMIZER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../../DArray/include/BigNat.hpp"
+#include "Bytecode.hpp"
+#include "Value.hpp"
+#include "ValueHeap.hpp"
+
+// Оптимизация скомпилированной программы по окнам из соседних инструкций: свёртка констант и условий
+// с константой, слияние отношения с ji, vset и vscatter с pop и шаблона push y / push 1 / + / pop y
+// в одну инструкцию, удаление недостижимых инструкций. Окно, внутрь которого есть переход, не трогается.
+// Составная инструкция получает строку той исходной, которая могла сообщить об ошибке, поэтому сообщения
+// остаются прежними.
+class Optimizer {
+    Bytecode &bytecode;
+    std::vector<Value> &constants; // свёрнутые константы добавляются в конец
+    ValueHeap &heap;
+    std::vector<bool> targets; // на инструкцию есть переход
+    std::vector<bool> removed; // инструкция удаляется в конце прохода
+
+    // Инструкции first .. first + count - 1 есть, не удалены и внутрь окна нет переходов
+    [[nodiscard]] bool window(std::size_t first, std::size_t count) const;
+
+    BigNat number(std::uint32_t constant); // значение константы программы
+
+    bool foldConstant(std::size_t i); // push a / push b / операция -> push результат
+
+    bool foldBranch(std::size_t i); // push константа / ji -> jmp или ничего
+
+    bool fuseIncrement(std::size_t i); // push y / push 1 / + или - / pop y -> inc y или dec y
+
+    bool fuseBranch(std::size_t i); // отношение / ji -> условный переход
+
+    bool fuseStore(std::size_t i); // vset или vscatter / pop y -> изменение вектора в переменной y на месте
+
+    bool removeJumpToNext(std::size_t i);
+
+    bool rewrite(); // один проход по окнам; true, если программа изменилась
+
+    bool removeUnreachable();
+
+    void compact(); // удаляет отмеченные инструкции и пересчитывает адреса переходов
+
+public:
+    Optimizer(Bytecode &bytecode, std::vector<Value> &constants, ValueHeap &heap);
+
+    void optimize(); // проходы повторяются, пока программа меняется
+};
+
+#endif //OPTIMIZER_HPP
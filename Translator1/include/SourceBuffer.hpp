@@ -0,0 +1,34 @@
+#ifndef SOURCEBUFFER_HPP
+#define SOURCEBUFFER_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Текст программы в памяти: либо отображённый через mmap файл, либо собственная строка
+class SourceBuffer {
+    std::string owned; // текст, переданный строкой
+    void *mapping; // отображение файла или nullptr
+    std::size_t mappingSize;
+
+public:
+    SourceBuffer();
+
+    explicit SourceBuffer(std::string text);
+
+    SourceBuffer(const SourceBuffer &) = delete;
+
+    SourceBuffer(SourceBuffer &&other) noexcept;
+
+    SourceBuffer &operator=(const SourceBuffer &) = delete;
+
+    SourceBuffer &operator=(SourceBuffer &&other) noexcept;
+
+    ~SourceBuffer();
+
+    static SourceBuffer map(const std::string &filePath); // бросает std::runtime_error
+
+    [[nodiscard]] std::string_view view() const;
+};
+
+#endif //SOURCEBUFFER_HPP
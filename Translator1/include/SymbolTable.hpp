@@ -0,0 +1,46 @@
+#ifndef SYMBOLTABLE_HPP
+#define SYMBOLTABLE_HPP
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "InternTable.hpp"
+
+// Таблица имён: номера выдаются подряд в порядке добавления. Сами имена по возможности
+// остаются ссылками на текст программы, остальные копируются в таблицу.
+class SymbolTable {
+    InternTable<std::string_view, std::hash<std::string_view>> names;
+    std::deque<std::string> ownedNames; // копии имён, которых нет в тексте программы
+
+public:
+    SymbolTable() = default;
+
+    // Копия ссылалась бы на чужие строки, поэтому таблица только перемещается
+    SymbolTable(const SymbolTable &) = delete;
+
+    SymbolTable(SymbolTable &&) = default;
+
+    SymbolTable &operator=(const SymbolTable &) = delete;
+
+    SymbolTable &operator=(SymbolTable &&) = default;
+
+    // Номер имени, при необходимости добавленного. Если borrowed, строка не копируется:
+    // вызывающий гарантирует, что она переживёт таблицу
+    unsigned intern(std::string_view name, bool borrowed = false);
+
+    [[nodiscard]] const unsigned *find(std::string_view name) const { return names.find(name); } // nullptr, если имени нет
+
+    [[nodiscard]] std::string_view name(unsigned id) const { return names[id]; }
+
+    [[nodiscard]] const std::vector<std::string_view> &all() const { return names.all(); } // в порядке номеров
+
+    [[nodiscard]] std::size_t size() const { return names.size(); }
+
+    [[nodiscard]] bool empty() const { return names.empty(); }
+};
+
+#endif //SYMBOLTABLE_HPP
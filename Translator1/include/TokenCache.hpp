@@ -0,0 +1,34 @@
+#ifndef TOKENCACHE_HPP
+#define TOKENCACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "LexicalAnalyzer.hpp"
+
+// Двоичный снимок результата лексического анализа, привязанный к хешу исходного текста.
+// При загрузке файл отображается в память: столбцы лексем и имена читаются прямо из него.
+class TokenCache {
+public:
+    // Меняется при любом изменении формата. С версии 3 в кэше только результаты без сообщений об ошибках
+    static constexpr std::uint32_t version = 3;
+
+    static std::uint64_t hashSource(std::string_view source);
+
+    // Файл кэша для текста с данным хешем в каталоге directory
+    static std::string path(const std::string &directory, std::uint64_t sourceHash);
+
+    // Сообщения result.diagnostics не сохраняются: результат с ними кэшировать нельзя.
+    // Бросает std::runtime_error
+    static void save(const std::string &cachePath, std::string_view source, std::uint64_t sourceHash,
+                     const LexResult &result);
+
+    // Результат из кэша; nullopt, если файла нет, он другой версии, построен по другому тексту или повреждён
+    static std::optional<LexResult> load(const std::string &cachePath, std::string_view source,
+                                         std::uint64_t sourceHash);
+};
+
+#endif //TOKENCACHE_HPP
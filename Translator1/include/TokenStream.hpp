@@ -0,0 +1,182 @@
+#ifndef TOKENSTREAM_HPP
+#define TOKENSTREAM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "Lexeme.hpp"
+
+// Поток лексем, разложенный по столбцам: класс, значение и номер строки хранятся отдельно.
+// Номер строки записывается приростом относительно предыдущей лексемы в одном байте;
+// редкие большие приросты вынесены в отдельную таблицу.
+class TokenStream {
+public:
+    static constexpr std::uint8_t farDelta = 0xFF; // номер строки лежит в farLines
+
+    // Столбец: собственный вектор или чужой буфер только для чтения (например, отображённый файл).
+    // Перед первым изменением чужой столбец копируется к себе
+    template<typename T>
+    class Column {
+        std::vector<T> owned;
+        const T *items = nullptr;
+        std::size_t count = 0;
+        bool borrowed = false;
+
+        void sync() {
+            items = owned.data();
+            count = owned.size();
+        }
+
+        void own() {
+            if (borrowed) {
+                owned.assign(items, items + count);
+                borrowed = false;
+                sync();
+            }
+        }
+
+    public:
+        Column() = default;
+
+        explicit Column(std::span<const T> external) : items(external.data()), count(external.size()), borrowed(true) {}
+
+        Column(const Column &other) : owned(other.begin(), other.end()) { sync(); }
+
+        Column(Column &&other) noexcept
+            : owned(std::move(other.owned)), items(std::exchange(other.items, nullptr)),
+              count(std::exchange(other.count, 0)), borrowed(std::exchange(other.borrowed, false)) {}
+
+        Column &operator=(Column other) noexcept {
+            owned.swap(other.owned);
+            std::swap(items, other.items);
+            std::swap(count, other.count);
+            std::swap(borrowed, other.borrowed);
+
+            return *this;
+        }
+
+        const T &operator[](std::size_t index) const { return items[index]; }
+
+        [[nodiscard]] const T *begin() const { return items; }
+
+        [[nodiscard]] const T *end() const { return items + count; }
+
+        [[nodiscard]] std::size_t size() const { return count; }
+
+        [[nodiscard]] std::size_t ownedBytes() const { return owned.capacity() * sizeof(T); }
+
+        void push_back(T item) {
+            own();
+            owned.push_back(item);
+            sync();
+        }
+
+        void reserve(std::size_t capacity) {
+            own();
+            owned.reserve(capacity);
+            sync();
+        }
+
+        void set(std::size_t index, T item) {
+            own();
+            owned[index] = item;
+        }
+
+        // Замена элементов [first, last) на [from, to)
+        void splice(std::size_t first, std::size_t last, const T *from, const T *to) {
+            own();
+            const auto position = owned.erase(owned.begin() + static_cast<std::ptrdiff_t>(first),
+                                              owned.begin() + static_cast<std::ptrdiff_t>(last));
+            owned.insert(position, from, to);
+            sync();
+        }
+    };
+
+private:
+    Column<std::uint16_t> classes;
+    Column<std::uint32_t> values;
+    Column<std::uint8_t> lineDeltas;
+    std::vector<std::pair<std::size_t, unsigned>> farLines; // номер лексемы и её строка
+    unsigned lastLine = 0;
+
+    [[nodiscard]] unsigned lineAt(std::size_t index) const;
+
+public:
+    class Iterator {
+        const TokenStream *stream;
+        std::size_t index;
+        unsigned line; // строка лексемы index
+        std::size_t farIndex; // первая ещё не пройденная запись farLines
+
+        void decodeLine();
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Lexeme;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Lexeme;
+
+        Iterator() : stream(nullptr), index(0), line(0), farIndex(0) {}
+
+        Iterator(const TokenStream *stream, std::size_t index);
+
+        Lexeme operator*() const;
+
+        Iterator &operator++();
+
+        Iterator operator++(int);
+
+        bool operator==(const Iterator &other) const { return index == other.index; }
+    };
+
+    TokenStream() = default;
+
+    // Поток поверх готовых столбцов во внешнем буфере, который должен пережить поток
+    TokenStream(std::span<const std::uint16_t> classes, std::span<const std::uint32_t> values,
+                std::span<const std::uint8_t> lineDeltas, std::vector<std::pair<std::size_t, unsigned>> farLines,
+                unsigned lastLine);
+
+    void push_back(const Lexeme &lexeme);
+
+    void reserve(std::size_t count);
+
+    // Замена лексем [first, last) на replacement; строки лексем после last сдвигаются на lineShift
+    void replace(std::size_t first, std::size_t last, const TokenStream &replacement, std::int64_t lineShift);
+
+    // Номер первой лексемы, стоящей в строке line или дальше
+    [[nodiscard]] std::size_t lowerBound(unsigned line) const;
+
+    void setValue(std::size_t index, unsigned value) { values.set(index, value); }
+
+    [[nodiscard]] LexemeClass lexemeClass(std::size_t index) const { return static_cast<LexemeClass>(classes[index]); }
+
+    [[nodiscard]] unsigned value(std::size_t index) const { return values[index]; }
+
+    [[nodiscard]] std::size_t size() const { return classes.size(); }
+
+    [[nodiscard]] bool empty() const { return classes.size() == 0; }
+
+    [[nodiscard]] std::size_t memoryBytes() const; // память, принадлежащая потоку
+
+    // Столбцы как есть, для записи в файл
+    [[nodiscard]] std::span<const std::uint16_t> classColumn() const { return {classes.begin(), classes.size()}; }
+
+    [[nodiscard]] std::span<const std::uint32_t> valueColumn() const { return {values.begin(), values.size()}; }
+
+    [[nodiscard]] std::span<const std::uint8_t> lineDeltaColumn() const { return {lineDeltas.begin(), lineDeltas.size()}; }
+
+    [[nodiscard]] const std::vector<std::pair<std::size_t, unsigned>> &farLineTable() const { return farLines; }
+
+    [[nodiscard]] unsigned lastLineNumber() const { return lastLine; }
+
+    [[nodiscard]] Iterator begin() const { return {this, 0}; }
+
+    [[nodiscard]] Iterator end() const { return {this, size()}; }
+};
+
+#endif //TOKENSTREAM_HPP
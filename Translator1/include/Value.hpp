@@ -0,0 +1,42 @@
+#ifndef VALUE_HPP
+#define VALUE_HPP
+
+#include <cstdint>
+
+// Значение стека и переменных в одном слове. Младший бит 1 — натуральное число меньше 2^63
+// прямо в слове; иначе биты 1–2 задают вид объекта, а старшие биты — его номер в куче значений.
+// Нулевое слово — пустое значение (переменной ещё не присваивали).
+class Value {
+    std::uint64_t bits = 0;
+
+    explicit Value(std::uint64_t bits) : bits(bits) {}
+
+public:
+    enum class Kind : std::uint8_t { EMPTY, NUMBER, VECTOR, MATRIX }; // NUMBER — длинное число в куче
+
+    static constexpr std::uint64_t maxInline = (std::uint64_t{1} << 63) - 1;
+
+    Value() = default;
+
+    static Value number(std::uint64_t value) { return Value(value << 1 | 1); } // value <= maxInline
+
+    static Value object(Kind kind, std::uint32_t handle) {
+        return Value(std::uint64_t{handle} << 3 | static_cast<std::uint64_t>(kind) << 1);
+    }
+
+    [[nodiscard]] bool empty() const { return bits == 0; }
+
+    [[nodiscard]] bool isInline() const { return bits & 1; }
+
+    [[nodiscard]] std::uint64_t inlineNumber() const { return bits >> 1; }
+
+    [[nodiscard]] Kind kind() const { return isInline() ? Kind::NUMBER : static_cast<Kind>(bits >> 1 & 3); }
+
+    [[nodiscard]] std::uint32_t handle() const { return static_cast<std::uint32_t>(bits >> 3); }
+
+    bool operator==(const Value &other) const = default; // то же число или тот же объект кучи
+};
+
+static_assert(sizeof(Value) == 8);
+
+#endif //VALUE_HPP
@@ -0,0 +1,173 @@
+#ifndef VALUEHEAP_HPP
+#define VALUEHEAP_HPP
+
+#include <cstdint>
+#include <iosfwd>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../../DArray/include/BigNat.hpp"
+#include "../../DArray/include/DArray.hpp"
+#include "../../DArray/include/Matrix.hpp"
+#include "Value.hpp"
+
+// Куча объектов, на которые ссылаются значения: длинные числа, векторы и матрицы.
+// Объект живёт, пока на него есть ссылки; номера освободившихся объектов выдаются повторно.
+// Копирование значения стоит одного увеличения счётчика, а объект с единственной ссылкой
+// забирается без копирования.
+class ValueHeap {
+    template<typename T>
+    class Pool {
+        std::vector<T> objects;
+        std::vector<std::uint32_t> references; // 0 — номер свободен
+        std::vector<std::uint32_t> freeHandles;
+
+        void free(std::uint32_t handle) {
+            objects[handle] = T{};
+            references[handle] = 0;
+            freeHandles.push_back(handle);
+        }
+
+    public:
+        std::uint32_t allocate(T &&object) {
+            if (freeHandles.empty()) {
+                objects.push_back(std::move(object));
+                references.push_back(1);
+                return static_cast<std::uint32_t>(objects.size() - 1);
+            }
+
+            const std::uint32_t handle = freeHandles.back();
+            freeHandles.pop_back();
+            objects[handle] = std::move(object);
+            references[handle] = 1;
+
+            return handle;
+        }
+
+        [[nodiscard]] const T &operator[](std::uint32_t handle) const { return objects[handle]; }
+
+        T &operator[](std::uint32_t handle) { return objects[handle]; }
+
+        [[nodiscard]] std::uint32_t referenceCount(std::uint32_t handle) const { return references[handle]; }
+
+        void retain(std::uint32_t handle) { ++references[handle]; }
+
+        void release(std::uint32_t handle) {
+            if (--references[handle] == 0)
+                free(handle);
+        }
+
+        // Объект вместе с одной ссылкой на него: последняя ссылка отдаёт сам объект, иначе копию
+        T take(std::uint32_t handle) {
+            if (references[handle] > 1) {
+                --references[handle];
+                return objects[handle];
+            }
+
+            T object = std::move(objects[handle]);
+            free(handle);
+
+            return object;
+        }
+    };
+
+    Pool<BigNat> numbers;
+    Pool<DArray> vectors;
+    Pool<Matrix> matrices;
+
+    template<typename T>
+    static constexpr Value::Kind kindOf = std::is_same_v<T, BigNat> ? Value::Kind::NUMBER
+                                          : std::is_same_v<T, DArray> ? Value::Kind::VECTOR
+                                          : Value::Kind::MATRIX;
+
+    template<typename T>
+    Pool<T> &pool() {
+        if constexpr (std::is_same_v<T, BigNat>) return numbers;
+        else if constexpr (std::is_same_v<T, DArray>) return vectors;
+        else return matrices;
+    }
+
+    template<typename T>
+    const Pool<T> &pool() const { return const_cast<ValueHeap *>(this)->pool<T>(); }
+
+    template<typename T>
+    void checkKind(Value value) const {
+        if (value.isInline() || value.kind() != kindOf<T>)
+            throwKind(kindOf<T>);
+    }
+
+    [[noreturn]] static void throwKind(Value::Kind expected);
+
+public:
+    Value make(BigNat number);
+
+    Value make(DArray vector) { return Value::object(Value::Kind::VECTOR, vectors.allocate(std::move(vector))); }
+
+    Value make(Matrix matrix) { return Value::object(Value::Kind::MATRIX, matrices.allocate(std::move(matrix))); }
+
+    void retain(Value value);
+
+    void release(Value value);
+
+    // Объект значения вместе со ссылкой value; если вид не тот, бросает std::runtime_error и ссылку не трогает
+    template<typename T>
+    T take(Value value) {
+        if constexpr (std::is_same_v<T, BigNat>)
+            if (value.isInline())
+                return {value.inlineNumber()};
+
+        checkKind<T>(value);
+
+        return pool<T>().take(value.handle());
+    }
+
+    // Объект вектора или матрицы без копирования; ссылка value остаётся. Если вид не тот, бросает
+    // std::runtime_error. Ссылка на объект действительна до следующего make того же вида
+    template<typename T>
+    const T &view(Value value) const {
+        static_assert(!std::is_same_v<T, BigNat>, "число может храниться прямо в значении");
+        checkKind<T>(value);
+
+        return pool<T>()[value.handle()];
+    }
+
+    // Объект, который можно менять на месте: на него не больше owners ссылок. Иначе nullptr, как и при
+    // неподходящем виде — тогда изменение идёт через take и копию
+    template<typename T>
+    T *unshared(Value value, std::uint32_t owners) {
+        static_assert(!std::is_same_v<T, BigNat>, "число может храниться прямо в значении");
+        if (value.isInline() || value.kind() != kindOf<T> || pool<T>().referenceCount(value.handle()) > owners)
+            return nullptr;
+
+        return &pool<T>()[value.handle()];
+    }
+
+    void print(std::ostream &os, Value value) const;
+};
+
+inline void ValueHeap::retain(Value value) {
+    if (value.isInline())
+        return;
+
+    switch (value.kind()) {
+        case Value::Kind::NUMBER: numbers.retain(value.handle()); break;
+        case Value::Kind::VECTOR: vectors.retain(value.handle()); break;
+        case Value::Kind::MATRIX: matrices.retain(value.handle()); break;
+        case Value::Kind::EMPTY: break;
+    }
+}
+
+inline void ValueHeap::release(Value value) {
+    if (value.isInline())
+        return;
+
+    switch (value.kind()) {
+        case Value::Kind::NUMBER: numbers.release(value.handle()); break;
+        case Value::Kind::VECTOR: vectors.release(value.handle()); break;
+        case Value::Kind::MATRIX: matrices.release(value.handle()); break;
+        case Value::Kind::EMPTY: break;
+    }
+}
+
+#endif //VALUEHEAP_HPP
@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#include "../include/IncrementalLexer.hpp"
+
+IncrementalLexer::IncrementalLexer(std::string source) : text(std::move(source)) {
+    indexLines();
+    relex(1, lineCount(), 0, 0, 0);
+}
+
+void IncrementalLexer::indexLines() {
+    lineStarts.assign(1, 0);
+    for (std::size_t i = 0; i < text.size(); ++i)
+        if (text[i] == '\n')
+            lineStarts.push_back(i + 1);
+}
+
+void IncrementalLexer::edit(unsigned firstLine, unsigned lineCount, std::string_view newLines) {
+    const unsigned oldCount = this->lineCount();
+    if (firstLine == 0 || firstLine > oldCount + 1 || lineCount > oldCount + 1 - firstLine)
+        throw std::out_of_range("Правка выходит за пределы программы");
+
+    std::string replacement(newLines);
+    if (!replacement.empty() && replacement.back() != '\n')
+        replacement += '\n';
+
+    // Правка у конца текста затрагивает и предыдущую строку: у неё появляется или пропадает
+    // перевод строки, а вместе с ним меняется разбор конца файла
+    const bool toEnd = firstLine + lineCount > oldCount;
+    if (toEnd) {
+        if (firstLine > 1) {
+            --firstLine;
+            ++lineCount;
+
+            const std::size_t begin = lineStarts[firstLine - 1];
+            const std::size_t end = firstLine < oldCount ? lineStarts[firstLine] : text.size();
+            std::string previous = text.substr(begin, end - begin);
+            if (firstLine == oldCount)
+                previous += '\n';
+            replacement.insert(0, previous);
+        }
+
+        // Последняя строка текста не оканчивается переводом строки
+        if (!replacement.empty())
+            replacement.pop_back();
+    }
+
+    const std::size_t oldBegin = lineStarts[firstLine - 1];
+    const std::size_t oldEnd = toEnd ? text.size() : lineStarts[firstLine - 1 + lineCount];
+    text.replace(oldBegin, oldEnd - oldBegin, replacement);
+
+    const auto newCount = static_cast<unsigned>(std::ranges::count(replacement, '\n') + (toEnd ? 1 : 0));
+    std::vector<std::size_t> starts;
+    if (newCount > 0)
+        starts.push_back(oldBegin);
+    for (std::size_t i = 0; i < replacement.size() && starts.size() < newCount; ++i)
+        if (replacement[i] == '\n')
+            starts.push_back(oldBegin + i + 1);
+
+    const auto first = lineStarts.begin() + static_cast<std::ptrdiff_t>(firstLine - 1);
+    const auto tail = lineStarts.erase(first, first + static_cast<std::ptrdiff_t>(lineCount));
+    for (auto start = tail; start != lineStarts.end(); ++start)
+        *start = *start - (oldEnd - oldBegin) + replacement.size();
+    lineStarts.insert(tail, starts.begin(), starts.end());
+
+    const TokenStream &tokens = lexResult.lexemes;
+    const std::size_t firstToken = tokens.lowerBound(firstLine);
+    std::size_t lastToken = toEnd ? tokens.size() : tokens.lowerBound(firstLine + lineCount);
+    unsigned lastLine = firstLine + newCount - 1;
+
+    // За правкой только пустые строки и комментарии: от правки зависит разбор конца файла
+    if (!toEnd && Lexer::onlyBlankLines(std::string_view(text).substr(lineStarts[firstLine - 1 + newCount]))) {
+        lastToken = tokens.size();
+        lastLine = this->lineCount();
+    }
+
+    relex(firstLine, lastLine, firstToken, lastToken,
+          static_cast<std::int64_t>(newCount) - static_cast<std::int64_t>(lineCount));
+}
+
+void IncrementalLexer::relex(unsigned firstLine, unsigned lastLine, std::size_t firstToken, std::size_t lastToken,
+                             std::int64_t lineShift) {
+    TokenStream &tokens = lexResult.lexemes;
+
+    LexResult chunk;
+    if (firstLine <= lastLine) {
+        const bool atEnd = lastLine == lineCount();
+        const std::size_t begin = lineStarts[firstLine - 1];
+        const std::size_t end = atEnd ? text.size() : lineStarts[lastLine];
+
+        // Каждая значимая строка даёт хотя бы одну лексему, поэтому состояние начала строки
+        // определяется тем, были ли лексемы раньше
+        const States startState = firstToken == 0 ? States::states_A1 : States::states_A2;
+        chunk = Lexer{}.parseRange(std::string_view(text).substr(begin, end - begin), startState, firstLine, atEnd);
+    }
+
+    // Векторы лежат в таблице в порядке своих лексем, поэтому заменяется непрерывный участок
+    auto firstVector = static_cast<unsigned>(lexResult.vectors.size());
+    unsigned removedVectors = 0;
+    bool vectorFound = false;
+    for (std::size_t i = firstToken; i < tokens.size(); ++i) {
+        if (tokens.lexemeClass(i) != LexemeClass::VECTOR)
+            continue;
+
+        if (!vectorFound) {
+            firstVector = tokens.value(i);
+            vectorFound = true;
+        }
+
+        if (i >= lastToken)
+            break;
+        ++removedVectors;
+    }
+
+    // Текст меняется при правках, поэтому имена копируются в таблицу
+    std::vector<unsigned> renumber(chunk.nameTable.size());
+    for (unsigned id = 0; id < renumber.size(); ++id)
+        renumber[id] = lexResult.nameTable.intern(chunk.nameTable.name(id));
+
+    // Константы, исчезнувшие из текста, остаются в пуле: индексы остальных не меняются
+    std::vector<unsigned> constantIndex(chunk.constantTable.size());
+    for (unsigned index = 0; index < constantIndex.size(); ++index)
+        constantIndex[index] = lexResult.constantTable.intern(chunk.constantTable.value(index));
+
+    TokenStream replacement;
+    replacement.reserve(chunk.lexemes.size());
+    LexemeClass previousClass{};
+    for (Lexeme lexeme: chunk.lexemes) {
+        if (lexeme.lexemeClass == LexemeClass::VARIABLE)
+            lexeme.value = renumber[lexeme.value];
+        else if (lexeme.lexemeClass == LexemeClass::VECTOR)
+            lexeme.value += firstVector;
+        else if (isPooledConstant(previousClass, lexeme.lexemeClass))
+            lexeme.value = constantIndex[lexeme.value];
+        previousClass = lexeme.lexemeClass;
+        replacement.push_back(lexeme);
+    }
+
+    auto &vectors = lexResult.vectors;
+    const auto vectorAt = vectors.begin() + static_cast<std::ptrdiff_t>(firstVector);
+    const auto vectorEnd = vectorAt + static_cast<std::ptrdiff_t>(removedVectors);
+    vectors.insert(vectors.erase(vectorAt, vectorEnd), std::make_move_iterator(chunk.vectors.begin()),
+                   std::make_move_iterator(chunk.vectors.end()));
+
+    tokens.replace(firstToken, lastToken, replacement, lineShift);
+
+    // Векторы после правки сдвинулись в таблице
+    if (chunk.vectors.size() != removedVectors)
+        for (std::size_t i = firstToken + replacement.size(); i < tokens.size(); ++i)
+            if (tokens.lexemeClass(i) == LexemeClass::VECTOR)
+                tokens.setValue(i, static_cast<unsigned>(tokens.value(i) - removedVectors + chunk.vectors.size()));
+
+    // Сообщения о заменённых строках уступают место сообщениям нового разбора, следующие сдвигаются
+    const std::int64_t oldLastLine = static_cast<std::int64_t>(lastLine) - lineShift;
+    std::vector<Diagnostic> diagnostics;
+    for (Diagnostic &diagnostic: lexResult.diagnostics)
+        if (diagnostic.line < firstLine)
+            diagnostics.push_back(std::move(diagnostic));
+    diagnostics.insert(diagnostics.end(), std::make_move_iterator(chunk.diagnostics.begin()),
+                       std::make_move_iterator(chunk.diagnostics.end()));
+    for (Diagnostic &diagnostic: lexResult.diagnostics)
+        if (diagnostic.line > oldLastLine) {
+            diagnostic.line = static_cast<unsigned>(diagnostic.line + lineShift);
+            diagnostics.push_back(std::move(diagnostic));
+        }
+    lexResult.diagnostics = std::move(diagnostics);
+}
@@ -1,229 +1,810 @@
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <functional>
 #include <iostream>
 #include <fstream>
+#include <string_view>
 
 #include "../include/Interpreter.hpp"
 
-void Interpreter::execute() {
+namespace {
+    struct CommandInfo {
+        std::string_view name;
+        Opcode opcode;
+    };
+
+    // Для push код уточняется по операнду при компиляции
+    constexpr CommandInfo commands[] = {
+        {"push", Opcode::PUSH_VARIABLE}, {"pop", Opcode::POP}, {"read", Opcode::READ}, {"write", Opcode::WRITE},
+        {"+", Opcode::ADD}, {"-", Opcode::SUB}, {"*", Opcode::MUL}, {"/", Opcode::DIV}, {"%", Opcode::MOD},
+        {"vadd", Opcode::VADD}, {"vsub", Opcode::VSUB}, {"vmul", Opcode::VMUL}, {"vdiv", Opcode::VDIV},
+        {"vmod", Opcode::VMOD}, {"vdot", Opcode::VDOT}, {"vconcat", Opcode::VCONCAT}, {"vlshift", Opcode::VLSHIFT},
+        {"vrshift", Opcode::VRSHIFT}, {"mload", Opcode::MLOAD}, {"mmul", Opcode::MMUL}, {"mtrans", Opcode::MTRANS},
+        {"mrow", Opcode::MROW}, {"mcol", Opcode::MCOL}, {"vsort", Opcode::VSORT}, {"vfind", Opcode::VFIND},
+        {"vuniq", Opcode::VUNIQ}, {"vget", Opcode::VGET}, {"vset", Opcode::VSET}, {"vgather", Opcode::VGATHER},
+        {"vscatter", Opcode::VSCATTER}, {"<", Opcode::LESS}, {">", Opcode::GREATER}, {"<=", Opcode::LESS_EQUAL},
+        {">=", Opcode::GREATER_EQUAL}, {"=", Opcode::EQUAL}, {"!=", Opcode::NOT_EQUAL}, {"ji", Opcode::JI},
+        {"jmp", Opcode::JMP}, {"end", Opcode::END}
+    };
+}
+
+bool Interpreter::compile() {
     bool hasErrors = false;
+    Bytecode compiled;
+    std::vector<std::pair<std::size_t, std::int64_t>> jumps; // инструкция перехода и строка назначения (с нуля)
+    std::vector<std::size_t> firstInstruction(program.size()); // первая инструкция в строке или после неё
+    std::uint32_t nextVector = 0;
+
+    for (size_t line = 0; line < program.size(); line++) {
+        firstInstruction[line] = compiled.code.size();
+        const std::string &currentCmd = program[line];
+
+        if (currentCmd.empty() || currentCmd[0] == ';')
+            continue;
+
+        std::istringstream iss(currentCmd);
+        std::string command;
+        iss >> command;
+
+        const auto known = std::ranges::find(commands, command, &CommandInfo::name);
+        if (known == std::end(commands)) {
+            std::cerr << "Обнаружена ошибка в строке номер " << line + 1
+                    << ": неизвестная команда " << command << '\n';
+            hasErrors = true;
+            continue;
+        }
+
+        Instruction instruction{known->opcode, 0};
+        if (known->opcode == Opcode::PUSH_VARIABLE) {
+            std::string value;
+            iss >> value;
+
+            // Векторы в таблице идут в порядке их появления в тексте
+            if (value.size() >= 4 && value.substr(0, 2) == "<<")
+                instruction = {Opcode::PUSH_VECTOR, nextVector++};
+            else if (!value.empty() && std::isdigit(static_cast<unsigned char>(value[0]))) {
+                std::size_t constant = lineConstants[line];
+                if (constant == noConstant) {
+                    // Числа, которых нет в пуле (лексический анализатор отверг их как переполнение), разбираются здесь
+                    try {
+                        constants.push_back(heap.make(BigNat::parse(value)));
+                        constant = constants.size() - 1;
+                    } catch (const std::exception &e) {
+                        // Ошибка сообщается, только если строка будет выполнена
+                        compileErrors.emplace_back(e.what());
+                    }
+                }
+
+                instruction = constant != noConstant
+                                  ? Instruction{Opcode::PUSH_CONSTANT, static_cast<std::uint32_t>(constant)}
+                                  : Instruction{Opcode::FAIL, static_cast<std::uint32_t>(compileErrors.size() - 1)};
+            } else
+                instruction.operand = variableNames.intern(value);
+        } else if (known->opcode == Opcode::POP) {
+            std::string variable;
+            iss >> variable;
+            instruction.operand = variableNames.intern(variable);
+        } else if (known->opcode == Opcode::JI || known->opcode == Opcode::JMP) {
+            int targetLine = 0;
+            iss >> targetLine;
+            jumps.emplace_back(compiled.code.size(), std::int64_t{targetLine} - 1);
+        }
+
+        compiled.code.push_back(instruction);
+        compiled.lines.push_back(static_cast<unsigned>(line));
+    }
+
+    std::cout << std::flush;
 
-        for (size_t line = 0; line < program.size(); line++) {
-            const std::string &currentCmd = program[line];
-
-            if (currentCmd.empty() || currentCmd[0] == ';')
-                continue;
-
-            std::istringstream iss(currentCmd);
-            std::string command;
-            iss >> command;
-
-            if (command != "push" && command != "pop" && command != "read" &&
-                command != "write" && command != "+" && command != "-" &&
-                command != "*" && command != "/" && command != "%" &&
-                command != "vadd" && command != "vsub" && command != "vmul" &&
-                command != "vdiv" && command != "vmod" && command != "vdot" &&
-                command != "vconcat" && command != "vlshift" && command != "vrshift" &&
-                command != "<" && command != ">" && command != "<=" &&
-                command != ">=" && command != "=" && command != "!=" &&
-                command != "ji" && command != "jmp" && command != "end") {
-                std::cerr << "Обнаружена ошибка в строке номер " << line + 1
-                        << ": неизвестная команда " << command << '\n';
-                hasErrors = true;
+    if (hasErrors)
+        return false;
+
+    variables.resize(variableNames.size());
+
+    // Программа заканчивается инструкцией END, поэтому при выполнении выход за массив не проверяется
+    const std::size_t programEnd = compiled.code.size();
+    compiled.code.push_back({Opcode::END, 0});
+    compiled.lines.push_back(static_cast<unsigned>(program.size()));
+
+    // Строки назначения известны только после разбора всей программы; переход за её пределы завершает выполнение
+    for (const auto &[index, targetLine]: jumps) {
+        const bool inside = targetLine >= 0 && static_cast<std::uint64_t>(targetLine) < program.size();
+        compiled.code[index].operand = static_cast<std::uint32_t>(
+            inside ? firstInstruction[static_cast<std::size_t>(targetLine)] : programEnd);
+    }
+
+    bytecode = std::move(compiled);
+
+    return true;
+}
+
+void Interpreter::require(std::size_t count) const {
+    if (stack.size() < count)
+        throw std::runtime_error(count == 1 ? "Стек пуст" : "Недостаточно элементов в стеке");
+}
+
+template<typename T>
+T Interpreter::pop() {
+    // Значение неподходящего вида остаётся на стеке
+    T value = heap.take<T>(stack.back());
+    stack.pop_back();
+
+    return value;
+}
+
+template<typename T>
+void Interpreter::push(T object) {
+    stack.push_back(heap.make(std::move(object)));
+}
+
+void Interpreter::drop() {
+    heap.release(stack.back());
+    stack.pop_back();
+}
+
+DArray *Interpreter::unsharedVector(Instruction instruction, Value vector) {
+    const bool toVariable = instruction.opcode == Opcode::VSET_VARIABLE ||
+                            instruction.opcode == Opcode::VSCATTER_VARIABLE;
+    if (toVariable && vector == variables[instruction.operand])
+        return heap.unshared<DArray>(vector, 2);
+
+    return heap.unshared<DArray>(vector, 1);
+}
+
+void Interpreter::storeResult(Instruction instruction) {
+    if (instruction.opcode != Opcode::VSET_VARIABLE && instruction.opcode != Opcode::VSCATTER_VARIABLE)
+        return;
+
+    heap.release(variables[instruction.operand]);
+    variables[instruction.operand] = stack.back();
+    stack.pop_back();
+}
+
+template<typename T, typename Operation>
+void Interpreter::binary(Operation operation) {
+    require(2);
+    auto b = pop<T>();
+    auto a = pop<T>();
+    push(operation(a, b));
+}
+
+void Interpreter::execute(Dispatch dispatch, bool optimize) {
+    if (!compile())
+        return;
+
+    if (optimize)
+        Optimizer(bytecode, constants, heap).optimize();
+
+    stack.reserve(initialStackCapacity);
+
+#if RGR4_COMPUTED_GOTO
+    if (dispatch == Dispatch::THREADED) {
+        run<Dispatch::THREADED>();
+        return;
+    }
+#else
+    static_cast<void>(dispatch);
+#endif
+
+    run<Dispatch::SWITCH>();
+}
+
+void Interpreter::executeSlow(Instruction instruction) {
+    switch (instruction.opcode) {
+        case Opcode::READ: {
+            std::string input;
+            std::getline(std::cin, input);
+            if (input.size() >= 4 && input.substr(0, 2) == "<<") {
+                std::stringstream ss(input);
+                DArray arr;
+                ss >> arr;
+                push(std::move(arr));
+            } else
+                push(BigNat::parse(input));
+            break;
+        }
+        case Opcode::WRITE:
+            require(1);
+            heap.print(std::cout, stack.back());
+            if (stack.back().kind() == Value::Kind::NUMBER)
+                std::cout << std::endl;
+            else
+                std::cout << '\n';
+            heap.release(stack.back());
+            stack.pop_back();
+            break;
+        case Opcode::VADD:
+            binary<DArray>(std::plus<>{});
+            break;
+        case Opcode::VSUB:
+            binary<DArray>(std::minus<>{});
+            break;
+        case Opcode::VMUL:
+            binary<DArray>(std::multiplies<>{});
+            break;
+        case Opcode::VDIV:
+            binary<DArray>(std::divides<>{});
+            break;
+        case Opcode::VMOD:
+            binary<DArray>(std::modulus<>{});
+            break;
+        case Opcode::VDOT:
+            binary<DArray>([](const DArray &a, const DArray &b) { return a.dot(b); });
+            break;
+        case Opcode::VCONCAT:
+            binary<DArray>(std::bit_and<>{});
+            break;
+        case Opcode::VLSHIFT:
+        case Opcode::VRSHIFT: {
+            require(2);
+            auto shift = pop<BigNat>().toUnsigned();
+            auto vec = pop<DArray>();
+            push(instruction.opcode == Opcode::VLSHIFT ? vec << shift : vec >> shift);
+            break;
+        }
+        case Opcode::VSORT:
+        case Opcode::VUNIQ: {
+            require(1);
+            auto vec = pop<DArray>();
+            if (instruction.opcode == Opcode::VSORT) vec.sort();
+            else vec.unique();
+            push(std::move(vec));
+            break;
+        }
+        case Opcode::VFIND: {
+            require(2);
+            auto value = pop<BigNat>();
+            const DArray &vec = heap.view<DArray>(stack.back());
+            // Натуральные числа больше INT_MAX в векторе встретиться не могут
+            const bool representable = value <= BigNat(static_cast<std::uint64_t>(INT_MAX));
+            const BigNat position(representable ? vec.find(static_cast<int>(value.toUnsigned())) : vec.getSize());
+            drop();
+            push(position);
+            break;
+        }
+        case Opcode::VGET: {
+            require(2);
+            auto index = pop<BigNat>().toUnsigned();
+            const int element = heap.view<DArray>(stack.back())[index];
+            drop();
+            push(fromElement(element));
+            break;
+        }
+        case Opcode::VSET:
+        case Opcode::VSET_VARIABLE: {
+            require(3);
+            auto value = toElement(pop<BigNat>());
+            auto index = pop<BigNat>().toUnsigned();
+            if (DArray *vec = unsharedVector(instruction, stack.back()))
+                vec->set(index, value);
+            else {
+                DArray copy = heap.view<DArray>(stack.back());
+                copy.set(index, value);
+                drop();
+                push(std::move(copy));
+            }
+            storeResult(instruction);
+            break;
+        }
+        case Opcode::VGATHER: {
+            require(2);
+            const DArray &indices = heap.view<DArray>(stack.back());
+            DArray result = heap.view<DArray>(stack[stack.size() - 2]).gather(indices);
+            drop();
+            drop();
+            push(std::move(result));
+            break;
+        }
+        case Opcode::VSCATTER:
+        case Opcode::VSCATTER_VARIABLE: {
+            require(3);
+            const DArray &values = heap.view<DArray>(stack.back());
+            const DArray &indices = heap.view<DArray>(stack[stack.size() - 2]);
+            const Value target = stack[stack.size() - 3];
+            if (DArray *vec = unsharedVector(instruction, target)) {
+                vec->scatter(indices, values);
+                drop();
+                drop();
+            } else {
+                DArray copy = heap.view<DArray>(target);
+                copy.scatter(indices, values);
+                drop();
+                drop();
+                drop();
+                push(std::move(copy));
             }
+            storeResult(instruction);
+            break;
         }
+        case Opcode::MLOAD: {
+            require(2);
+            auto rows = pop<BigNat>().toUnsigned();
+            auto elements = pop<DArray>();
+            push(Matrix(elements, rows));
+            break;
+        }
+        case Opcode::MMUL:
+            require(2);
+            if (stack.back().kind() == Value::Kind::VECTOR) {
+                auto vec = pop<DArray>();
+                auto a = pop<Matrix>();
+                push(a * vec);
+            } else {
+                auto b = pop<Matrix>();
+                auto a = pop<Matrix>();
+                push(a * b);
+            }
+            break;
+        case Opcode::MTRANS: {
+            require(1);
+            auto matrix = pop<Matrix>();
+            push(matrix.transpose());
+            break;
+        }
+        case Opcode::MROW:
+        case Opcode::MCOL: {
+            require(2);
+            auto index = pop<BigNat>().toUnsigned();
+            auto matrix = pop<Matrix>();
+            push(instruction.opcode == Opcode::MROW ? matrix.row(index) : matrix.column(index));
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+namespace {
+    // Операции над числами, хранящимися прямо в значении (меньше 2^63). false — результат не помещается
+    // в значение или операция невозможна: тогда её выполняет общий путь через BigNat и сообщает об ошибке
+    bool addInline(std::uint64_t a, std::uint64_t b, std::uint64_t &result) {
+        result = a + b;
+        return result <= Value::maxInline;
+    }
 
-        std::cout << std::flush;
+    bool subtractInline(std::uint64_t a, std::uint64_t b, std::uint64_t &result) {
+        result = a - b;
+        return a >= b;
+    }
+
+    bool multiplyInline(std::uint64_t a, std::uint64_t b, std::uint64_t &result) {
+        return !__builtin_mul_overflow(a, b, &result) && result <= Value::maxInline;
+    }
+
+    bool divideInline(std::uint64_t a, std::uint64_t b, std::uint64_t &result) {
+        result = b != 0 ? a / b : 0;
+        return b != 0;
+    }
+
+    bool modulusInline(std::uint64_t a, std::uint64_t b, std::uint64_t &result) {
+        result = b != 0 ? a % b : 0;
+        return b != 0;
+    }
+
+    template<typename Compare>
+    bool compareInline(std::uint64_t a, std::uint64_t b, std::uint64_t &result) {
+        result = Compare{}(a, b) ? 1 : 0;
+        return true;
+    }
 
-        if (hasErrors)
+    template<typename Compare>
+    BigNat compareNumbers(const BigNat &a, const BigNat &b) {
+        return {Compare{}(a, b) ? 1U : 0U};
+    }
+}
+
+// Обработчики написаны один раз для обоих способов выбора. При вычисляемом goto каждый обработчик
+// заканчивается своим косвенным переходом на следующий, иначе управление возвращается в общий switch.
+// Адреса меток и goto по адресу — расширение GCC и Clang, о котором предупреждает -pedantic
+#if RGR4_COMPUTED_GOTO
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#define HANDLER(name) case Opcode::name: name
+#define DISPATCH()                                                     \
+    do {                                                               \
+        if constexpr (dispatch == Dispatch::THREADED)                  \
+            goto *handlers[static_cast<std::size_t>(code[ip].opcode)]; \
+        else                                                           \
+            goto nextInstruction;                                      \
+    } while (false)
+#else
+#define HANDLER(name) case Opcode::name
+#define DISPATCH() goto nextInstruction
+#endif
+#define NEXT_INSTRUCTION() \
+    do {                   \
+        ++ip;              \
+        DISPATCH();        \
+    } while (false)
+
+template<Interpreter::Dispatch dispatch>
+void Interpreter::run() {
+    const Instruction *const code = bytecode.code.data();
+    std::size_t ip = 0;
+
+    // Вершина стека хранится в локальной переменной (в регистре), в stack лежит всё, что под ней.
+    // Перед обработчиками, которые работают со стеком целиком, и перед выходом вершина возвращается в stack.
+    // Второе значение в регистре не держится: при постоянной глубине кэша push сохранял бы его в stack,
+    // а операция подгружала бы следующее оттуда же, так что обращений к памяти не становится меньше.
+    // Выигрыш дал бы только кэш с переменной глубиной, но тогда каждому обработчику нужно по копии
+    // на каждое состояние кэша
+    Value top;
+    std::size_t depth = stack.size();
+    auto loadTop = [&] {
+        depth = stack.size();
+        if (depth > 0) {
+            top = stack.back();
+            stack.pop_back();
+        }
+    };
+    auto flushTop = [&] {
+        if (depth > 0)
+            stack.push_back(top);
+    };
+    auto pushTop = [&](Value value) {
+        if (depth++ > 0)
+            stack.push_back(top);
+        top = value;
+    };
+    auto popTop = [&] {
+        if (--depth > 0) {
+            top = stack.back();
+            stack.pop_back();
+        }
+    };
+    // a b -> a operation b; числа в значениях считаются на месте, остальное — через BigNat
+    auto numberOperation = [&](auto inlineOperation, auto operation) {
+        std::uint64_t result;
+        if (depth >= 2 && top.isInline() && stack.back().isInline() &&
+            inlineOperation(stack.back().inlineNumber(), top.inlineNumber(), result)) {
+            stack.pop_back();
+            --depth;
+            top = Value::number(result);
             return;
+        }
 
-        while (currentLine < program.size()) {
-            const std::string &line = program[currentLine];
+        flushTop();
+        binary<BigNat>(operation);
+        loadTop();
+    };
+    // a b -> true, если отношение выполнено; оба значения снимаются со стека
+    auto compareBranch = [&](auto compare) {
+        if (depth >= 2 && top.isInline() && stack.back().isInline()) {
+            const bool holds = compare(stack.back().inlineNumber(), top.inlineNumber());
+            stack.pop_back();
+            --depth;
+            popTop();
+            return holds;
+        }
 
-            if (line.empty() || line[0] == ';') {
-                currentLine++;
-                continue;
-            }
+        flushTop();
+        binary<BigNat>([compare](const BigNat &a, const BigNat &b) { return BigNat(compare(a, b) ? 1U : 0U); });
+        const bool holds = !pop<BigNat>().isZero();
+        loadTop();
+        return holds;
+    };
 
-            std::istringstream iss(line);
-            std::string command;
-            iss >> command;
-
-            try {
-                if (command == "push") {
-                    std::string value;
-                    iss >> value;
-
-                    if (value.size() >= 4 && value.substr(0, 2) == "<<") {
-                        if (vectorIndex < vectors.size()) {
-                            DArray arr(vectors[vectorIndex]);
-                            stack.emplace(arr);
-                            vectorIndex++;
-                        } else {
-                            std::cerr << "Вектор не найден в таблице векторов" << std::endl;
-                            return;
-                        }
-                    } else {
-                        try {
-                            int num = std::stoi(value);
-                            stack.emplace(num);
-                        } catch (const std::invalid_argument &) {
-                            if (variables.contains(value))
-                                stack.push(variables[value]);
-                            else {
-                                std::cerr << "Переменная " << value << " не найдена." << std::endl;
-                                return;
-                            }
-                        }
-                    }
-                } else if (command == "pop") {
-                    std::string variable;
-                    iss >> variable;
-                    if (stack.empty()) throw std::runtime_error("Стек пуст");
-                    variables[variable] = stack.top();
-                    stack.pop();
-                } else if (command == "read") {
-                    std::string input;
-                    std::getline(std::cin, input);
-                    if (input.size() >= 4 && input.substr(0, 2) == "<<") {
-                        std::stringstream ss(input);
-                        DArray arr;
-                        ss >> arr;
-                        stack.emplace(arr);
-                    } else
-                        stack.emplace(std::stoi(input));
-                } else if (command == "write") {
-                    if (stack.empty()) throw std::runtime_error("Стек пуст");
-                    if (auto *arr = std::get_if<DArray>(&stack.top()))
-                        std::cout << *arr << '\n';
-                    else
-                        std::cout << std::get<int>(stack.top()) << std::endl;
-                    stack.pop();
-                } else if (command == "+" || command == "-" || command == "*" || command == "/" || command == "%") {
-                    if (stack.size() < 2) throw std::runtime_error("Недостаточно элементов в стеке");
-                    auto b = std::get<int>(stack.top());
-                    stack.pop();
-                    auto a = std::get<int>(stack.top());
-                    stack.pop();
-                    int result;
-                    if (command == "+") result = a + b;
-                    else if (command == "-") result = a - b;
-                    else if (command == "*") result = a * b;
-                    else if (command == "/") result = a / b;
-                    else result = a % b;
-                    stack.emplace(result);
-                } else if (command == "vadd" || command == "vsub" || command == "vmul" ||
-                           command == "vdiv" || command == "vmod") {
-                    if (stack.size() < 2) throw std::runtime_error("Недостаточно элементов в стеке");
-                    auto b = std::get<DArray>(stack.top());
-                    stack.pop();
-                    auto a = std::get<DArray>(stack.top());
-                    stack.pop();
-                    if (command == "vadd") stack.emplace(a + b);
-                    else if (command == "vsub") stack.emplace(a - b);
-                    else if (command == "vmul") stack.emplace(a * b);
-                    else if (command == "vdiv") stack.emplace(a / b);
-                    else stack.emplace(a % b);
-                } else if (command == "vdot") {
-                    if (stack.size() < 2) throw std::runtime_error("Недостаточно элементов в стеке");
-                    auto b = std::get<DArray>(stack.top());
-                    stack.pop();
-                    auto a = std::get<DArray>(stack.top());
-                    stack.pop();
-                    stack.emplace(a.dot(b));
-                } else if (command == "vconcat") {
-                    if (stack.size() < 2) throw std::runtime_error("Недостаточно элементов в стеке");
-                    auto b = std::get<DArray>(stack.top());
-                    stack.pop();
-                    auto a = std::get<DArray>(stack.top());
-                    stack.pop();
-                    stack.emplace(a & b);
-                } else if (command == "vlshift" || command == "vrshift") {
-                    if (stack.size() < 2) throw std::runtime_error("Недостаточно элементов в стеке");
-                    auto shift = std::get<int>(stack.top());
-                    stack.pop();
-                    auto vec = std::get<DArray>(stack.top());
-                    stack.pop();
-                    stack.emplace(command == "vlshift"
-                                      ? vec << static_cast<unsigned>(shift)
-                                      : vec >> static_cast<unsigned>(shift));
-                } else if (command == "<" || command == ">" || command == "<=" ||
-                           command == ">=" || command == "=" || command == "!=") {
-                    if (stack.size() < 2) throw std::runtime_error("Недостаточно элементов в стеке");
-                    auto b = std::get<int>(stack.top());
-                    stack.pop();
-                    auto a = std::get<int>(stack.top());
-                    stack.pop();
-                    bool result;
-                    if (command == "<") result = a < b;
-                    else if (command == ">") result = a > b;
-                    else if (command == "<=") result = a <= b;
-                    else if (command == ">=") result = a >= b;
-                    else if (command == "=") result = a == b;
-                    else result = a != b;
-                    stack.emplace(result ? 1 : 0);
-                } else if (command == "ji") {
-                    int tempLine;
-                    iss >> tempLine;
-                    if (std::get<int>(stack.top()) > 0) {
-                        currentLine = static_cast<size_t>(tempLine - 1);
-                        stack.pop();
-                        continue;
-                    }
-                    stack.pop();
-                } else if (command == "jmp") {
-                    int tempLine;
-                    iss >> tempLine;
-                    currentLine = static_cast<size_t>(tempLine - 1);
-                    continue;
-                } else if (command == "end")
-                    break;
-                else
+    loadTop();
+
+#if RGR4_COMPUTED_GOTO
+    // Адреса обработчиков в порядке Opcode
+    [[maybe_unused]] static const void *const handlers[] = {
+        &&PUSH_CONSTANT, &&PUSH_VECTOR, &&PUSH_VARIABLE, &&POP, &&slowInstruction, &&slowInstruction,
+        &&ADD, &&SUB, &&MUL, &&DIV, &&MOD,
+        &&slowInstruction, &&slowInstruction, &&slowInstruction, &&slowInstruction, &&slowInstruction,
+        &&slowInstruction, &&slowInstruction, &&slowInstruction, &&slowInstruction, &&slowInstruction,
+        &&slowInstruction, &&slowInstruction, &&slowInstruction, &&slowInstruction, &&slowInstruction,
+        &&slowInstruction,
+        &&slowInstruction, &&slowInstruction, &&slowInstruction, &&slowInstruction, &&slowInstruction,
+        &&LESS, &&GREATER, &&LESS_EQUAL, &&GREATER_EQUAL, &&EQUAL, &&NOT_EQUAL,
+        &&JI, &&JMP, &&END,
+        &&INC, &&DEC, &&JLESS, &&JGREATER, &&JLESS_EQUAL, &&JGREATER_EQUAL, &&JEQUAL, &&JNOT_EQUAL,
+        &&slowInstruction, &&slowInstruction,
+        &&FAIL
+    };
+    static_assert(sizeof(handlers) / sizeof(handlers[0]) == static_cast<std::size_t>(Opcode::FAIL) + 1);
+#endif
+
+    try {
+    [[maybe_unused]] nextInstruction: // при вычисляемом goto сюда не возвращаются
+        switch (code[ip].opcode) {
+            HANDLER(PUSH_CONSTANT):
+                heap.retain(constants[code[ip].operand]);
+                pushTop(constants[code[ip].operand]);
+                NEXT_INSTRUCTION();
+            HANDLER(PUSH_VECTOR):
+                if (code[ip].operand >= vectors.size()) {
+                    flushTop();
+                    std::cerr << "Вектор не найден в таблице векторов" << std::endl;
+                    return;
+                }
+                heap.retain(vectors[code[ip].operand]);
+                pushTop(vectors[code[ip].operand]);
+                NEXT_INSTRUCTION();
+            HANDLER(PUSH_VARIABLE):
+                if (variables[code[ip].operand].empty()) {
+                    flushTop();
+                    std::cerr << "Переменная " << variableNames.name(code[ip].operand) << " не найдена." << std::endl;
                     return;
-                currentLine++;
-            } catch (const std::exception &e) {
-                std::cerr << "Ошибка на строке " << currentLine + 1 << ": " << e.what() << '\n';
+                }
+                heap.retain(variables[code[ip].operand]);
+                pushTop(variables[code[ip].operand]);
+                NEXT_INSTRUCTION();
+            HANDLER(POP):
+                if (depth == 0)
+                    throw std::runtime_error("Стек пуст");
+                heap.release(variables[code[ip].operand]);
+                variables[code[ip].operand] = top;
+                popTop();
+                NEXT_INSTRUCTION();
+            HANDLER(ADD):
+                numberOperation(addInline, std::plus<>{});
+                NEXT_INSTRUCTION();
+            HANDLER(SUB):
+                numberOperation(subtractInline, std::minus<>{});
+                NEXT_INSTRUCTION();
+            HANDLER(MUL):
+                numberOperation(multiplyInline, std::multiplies<>{});
+                NEXT_INSTRUCTION();
+            HANDLER(DIV):
+                numberOperation(divideInline, std::divides<>{});
+                NEXT_INSTRUCTION();
+            HANDLER(MOD):
+                numberOperation(modulusInline, std::modulus<>{});
+                NEXT_INSTRUCTION();
+            HANDLER(LESS):
+                numberOperation(compareInline<std::less<>>, compareNumbers<std::less<>>);
+                NEXT_INSTRUCTION();
+            HANDLER(GREATER):
+                numberOperation(compareInline<std::greater<>>, compareNumbers<std::greater<>>);
+                NEXT_INSTRUCTION();
+            HANDLER(LESS_EQUAL):
+                numberOperation(compareInline<std::less_equal<>>, compareNumbers<std::less_equal<>>);
+                NEXT_INSTRUCTION();
+            HANDLER(GREATER_EQUAL):
+                numberOperation(compareInline<std::greater_equal<>>, compareNumbers<std::greater_equal<>>);
+                NEXT_INSTRUCTION();
+            HANDLER(EQUAL):
+                numberOperation(compareInline<std::equal_to<>>, compareNumbers<std::equal_to<>>);
+                NEXT_INSTRUCTION();
+            HANDLER(NOT_EQUAL):
+                numberOperation(compareInline<std::not_equal_to<>>, compareNumbers<std::not_equal_to<>>);
+                NEXT_INSTRUCTION();
+            HANDLER(JI):
+                if (depth > 0 && top.isInline()) {
+                    const bool jump = top.inlineNumber() != 0;
+                    popTop();
+                    ip = jump ? code[ip].operand : ip + 1;
+                    DISPATCH();
+                }
+                flushTop();
+                require(1);
+                ip = pop<BigNat>().isZero() ? ip + 1 : code[ip].operand;
+                loadTop();
+                DISPATCH();
+            HANDLER(JMP):
+                ip = code[ip].operand;
+                DISPATCH();
+            HANDLER(END):
+                flushTop();
                 return;
-            }
+            HANDLER(INC):
+            HANDLER(DEC):
+                {
+                    Value &variable = variables[code[ip].operand];
+                    if (variable.empty()) {
+                        flushTop();
+                        std::cerr << "Переменная " << variableNames.name(code[ip].operand) << " не найдена." << std::endl;
+                        return;
+                    }
+
+                    const bool increment = code[ip].opcode == Opcode::INC;
+                    if (variable.isInline() &&
+                        (increment ? variable.inlineNumber() < Value::maxInline : variable.inlineNumber() > 0)) {
+                        variable = Value::number(increment ? variable.inlineNumber() + 1 : variable.inlineNumber() - 1);
+                        NEXT_INSTRUCTION();
+                    }
+
+                    // Длинное число или значение другого вида: те же шаги, что у push y / push 1 / + / pop y
+                    flushTop();
+                    heap.retain(variable);
+                    stack.push_back(variable);
+                    push(BigNat(1U));
+                    if (increment)
+                        binary<BigNat>(std::plus<>{});
+                    else
+                        binary<BigNat>(std::minus<>{});
+                    heap.release(variable);
+                    variable = stack.back();
+                    stack.pop_back();
+                    loadTop();
+                }
+                NEXT_INSTRUCTION();
+            HANDLER(JLESS):
+                ip = compareBranch(std::less<>{}) ? code[ip].operand : ip + 1;
+                DISPATCH();
+            HANDLER(JGREATER):
+                ip = compareBranch(std::greater<>{}) ? code[ip].operand : ip + 1;
+                DISPATCH();
+            HANDLER(JLESS_EQUAL):
+                ip = compareBranch(std::less_equal<>{}) ? code[ip].operand : ip + 1;
+                DISPATCH();
+            HANDLER(JGREATER_EQUAL):
+                ip = compareBranch(std::greater_equal<>{}) ? code[ip].operand : ip + 1;
+                DISPATCH();
+            HANDLER(JEQUAL):
+                ip = compareBranch(std::equal_to<>{}) ? code[ip].operand : ip + 1;
+                DISPATCH();
+            HANDLER(JNOT_EQUAL):
+                ip = compareBranch(std::not_equal_to<>{}) ? code[ip].operand : ip + 1;
+                DISPATCH();
+            HANDLER(FAIL):
+                flushTop();
+                throw std::runtime_error(compileErrors[code[ip].operand]);
+            case Opcode::READ:
+            case Opcode::WRITE:
+            case Opcode::VADD:
+            case Opcode::VSUB:
+            case Opcode::VMUL:
+            case Opcode::VDIV:
+            case Opcode::VMOD:
+            case Opcode::VDOT:
+            case Opcode::VCONCAT:
+            case Opcode::VLSHIFT:
+            case Opcode::VRSHIFT:
+            case Opcode::VSORT:
+            case Opcode::VFIND:
+            case Opcode::VUNIQ:
+            case Opcode::VGET:
+            case Opcode::VSET:
+            case Opcode::VGATHER:
+            case Opcode::VSCATTER:
+            case Opcode::VSET_VARIABLE:
+            case Opcode::VSCATTER_VARIABLE:
+            case Opcode::MLOAD:
+            case Opcode::MMUL:
+            case Opcode::MTRANS:
+            case Opcode::MROW:
+            case Opcode::MCOL:
+            [[maybe_unused]] slowInstruction:
+                flushTop();
+                executeSlow(code[ip]);
+                loadTop();
+                NEXT_INSTRUCTION();
         }
+    } catch (const std::exception &e) {
+        std::cerr << "Ошибка на строке " << bytecode.lines[ip] + 1 << ": " << e.what() << '\n';
+    }
+}
+
+#undef HANDLER
+#undef DISPATCH
+#undef NEXT_INSTRUCTION
+#if RGR4_COMPUTED_GOTO
+#pragma GCC diagnostic pop
+#endif
+
+int Interpreter::toElement(const BigNat &value) {
+    if (value > BigNat(static_cast<std::uint64_t>(INT_MAX)))
+        throw std::overflow_error("Число слишком велико для элемента вектора");
+
+    return static_cast<int>(value.toUnsigned());
+}
+
+BigNat Interpreter::fromElement(int value) {
+    if (value < 0)
+        throw std::domain_error("Элемент вектора не является натуральным числом");
+
+    return {static_cast<std::uint64_t>(value)};
 }
 
 void Interpreter::printStack() const {
     std::cout << "Содержимое стека:\n";
-    auto temp = stack;
-    while (!temp.empty()) {
-        if (auto *arr = std::get_if<DArray>(&temp.top()))
-            std::cout << *arr << ' ';
-        else
-            std::cout << std::get<int>(temp.top()) << ' ';
-        temp.pop();
-        std::cout << '\n';
+    for (auto value = stack.rbegin(); value != stack.rend(); ++value) {
+        heap.print(std::cout, *value);
+        std::cout << ' ' << '\n';
     }
 }
 
 void Interpreter::printVariables() const {
-    if (variables.empty())
+    std::vector<std::string_view> names;
+    for (unsigned slot = 0; slot < variables.size(); ++slot)
+        if (!variables[slot].empty())
+            names.push_back(variableNames.name(slot));
+
+    if (names.empty())
         std::cout << std::endl << "Переменные отсутствуют" << std::endl;
     else {
+        std::ranges::sort(names);
         std::cout << std::endl << "Переменные:" << '\n';
-        for (const auto &name: variables | std::views::keys)
+        for (const auto &name: names)
             std::cout << name << '\n';
     }
 
     std::cout << std::flush;
 }
 
-Interpreter::Interpreter(const std::vector<std::string> &programLines) : program(programLines), currentLine(0),
-                                                                         vectorIndex(0) {}
+void Interpreter::setMemoryBudget(std::size_t bytes) { ChunkStore::setMemoryBudget(bytes); }
+
+std::size_t Interpreter::getMemoryBudget() { return ChunkStore::getMemoryBudget(); }
+
+Interpreter::Interpreter(const std::vector<std::string> &programLines) : program(programLines) {
+    loadConstants(nullptr, {});
+}
 
 Interpreter::Interpreter(const std::vector<std::string> &programLines,
                          const std::vector<std::vector<unsigned>> &vectorsData)
-    : program(programLines), currentLine(0), vectorIndex(0) {
-    for (const auto &vec: vectorsData) {
-        DArray arr;
-        for (const auto &val: vec)
-            arr.push_back(static_cast<int>(val));
-        vectors.push_back(arr);
+    : program(programLines) {
+    loadVectors(vectorsData);
+    loadConstants(nullptr, {});
+}
+
+Interpreter::Interpreter(const std::vector<std::string> &programLines, const LexResult &lexResult)
+    : program(programLines) {
+    loadVectors(lexResult.vectors);
+
+    std::vector<std::size_t> pooled(program.size(), noConstant);
+    Lexeme previous{};
+    for (const Lexeme lexeme: lexResult.lexemes) {
+        matchPooledConstant(previous, lexeme, lexResult.constantTable, pooled);
+        previous = lexeme;
+    }
+
+    loadConstants(&lexResult.constantTable, pooled);
+    loadNames(lexResult.nameTable);
+}
+
+Interpreter::Interpreter(const std::vector<std::string> &programLines, Lexer &lexer)
+    : program(programLines) {
+    const LexResult &tables = lexer.tables();
+
+    // Векторы загружаются по мере появления их лексем, в том же порядке, что и в таблице векторов
+    std::vector<std::size_t> pooled(program.size(), noConstant);
+    Lexeme previous{};
+    Lexeme lexeme{};
+    while (lexer.next(lexeme)) {
+        if (lexeme.lexemeClass == LexemeClass::VECTOR && lexeme.value < tables.vectors.size())
+            loadVector(tables.vectors[lexeme.value]);
+
+        matchPooledConstant(previous, lexeme, tables.constantTable, pooled);
+        previous = lexeme;
     }
+
+    loadConstants(&tables.constantTable, pooled);
+    loadNames(tables.nameTable);
+}
+
+void Interpreter::loadVector(const std::vector<unsigned> &vectorData) {
+    vectors.push_back(heap.make(DArray(vectorData))); // элемент больше INT_MAX — std::overflow_error
+}
+
+void Interpreter::loadVectors(const std::vector<std::vector<unsigned>> &vectorsData) {
+    for (const auto &vec: vectorsData)
+        loadVector(vec);
+}
+
+void Interpreter::loadNames(const SymbolTable &nameTable) {
+    for (const std::string_view name: nameTable.all())
+        variableNames.intern(name);
+}
+
+void Interpreter::matchPooledConstant(const Lexeme &previous, const Lexeme &lexeme, const ConstantPool &pool,
+                                      std::vector<std::size_t> &pooled) const {
+    if (!isPooledConstant(previous.lexemeClass, lexeme.lexemeClass) || previous.lineNumber != lexeme.lineNumber ||
+        lexeme.lineNumber == 0 || lexeme.lineNumber > program.size() || lexeme.value >= pool.size())
+        return;
+
+    pooled[lexeme.lineNumber - 1] = lexeme.value;
+}
+
+void Interpreter::loadConstants(const ConstantPool *pool, const std::vector<std::size_t> &pooled) {
+    if (pool)
+        for (const unsigned value: pool->all())
+            constants.push_back(Value::number(value));
+
+    lineConstants = pooled;
+    lineConstants.resize(program.size(), noConstant);
 }
 
 std::vector<std::string> Interpreter::readFileIntoVector(const std::string &filePath) {
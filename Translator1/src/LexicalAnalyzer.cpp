@@ -1,34 +1,236 @@
-#include <iostream>
+#include <cstdio>
 #include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <utility>
 
 #include "LexicalAnalyzer.hpp"
+#include "SourceBuffer.hpp"
+#include "TokenCache.hpp"
+
+namespace {
+    // Код двухсимвольного отношения: строка — первый символ ('=', '!', '<', '>'), столбец — второй
+    constexpr unsigned relationTable[4][4] = {
+        {0, 0, 0, 0},
+        {static_cast<unsigned>(LexemeCodes::NOT_EQUAL), 0, 0, 0},
+        {static_cast<unsigned>(LexemeCodes::LESS_EQUAL), 0, 0, 0},
+        {static_cast<unsigned>(LexemeCodes::GREATER_EQUAL), 0, 0, 0}
+    };
+
+    // Класс каждого байта; '<' и '>' уточняются в transliterator() по следующему символу
+    constexpr std::array<SymbolicTokenClass, 256> characterClasses = [] {
+        std::array<SymbolicTokenClass, 256> classes{};
+        classes.fill(SymbolicTokenClass::ERROR);
 
-std::map<std::string, unsigned> nameTable;
-std::ifstream file;
-std::vector<std::vector<unsigned>> vectors;
-std::vector<unsigned> currentVector;
+        for (std::size_t ch = 'a'; ch <= 'z'; ++ch) {
+            classes[ch] = SymbolicTokenClass::LETTER;
+            classes[ch - 'a' + 'A'] = SymbolicTokenClass::LETTER;
+        }
+        for (std::size_t ch = '0'; ch <= '9'; ++ch)
+            classes[ch] = SymbolicTokenClass::DIGIT;
+        for (const char ch: {'+', '-', '*', '/', '%'})
+            classes[static_cast<unsigned char>(ch)] = SymbolicTokenClass::ARITHMETIC_OPERATION;
+        for (const char ch: {'=', '!', '<', '>'})
+            classes[static_cast<unsigned char>(ch)] = SymbolicTokenClass::COMPARISON_OPERATION;
+
+        classes[' '] = SymbolicTokenClass::SPACE_OR_TAB;
+        classes['\t'] = SymbolicTokenClass::SPACE_OR_TAB;
+        classes['\n'] = SymbolicTokenClass::END_OF_LINE;
+        classes[';'] = SymbolicTokenClass::SEMICOLON;
+        classes[','] = SymbolicTokenClass::COMMA;
+
+        return classes;
+    }();
+
+    // Состояния, в которых пробел или табуляция оставляют автомат на месте без побочных действий
+    bool absorbsBlanks(States state) {
+        switch (state) {
+            case States::states_A1:
+            case States::states_A2:
+            case States::states_C1:
+            case States::states_F1:
+            case States::states_F2:
+            case States::states_F3:
+            case States::states_I1:
+            case States::states_I2:
+            case States::states_J1:
+            case States::states_V1:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // Состояния, в которых тело комментария пропускается целиком
+    bool skipsComment(States state) {
+        return state == States::states_I1 || state == States::states_I2 || state == States::states_J1;
+    }
+
+    constexpr std::uint64_t repeatByte(std::uint8_t byte) {
+        return 0x0101010101010101ULL * byte;
+    }
 
-void addNameToTable(const std::string &name) {
-    auto it = nameTable.find(name);
+    // Ненулевые байты — не цифры. Перенос при сложении может пометить и байт после первой
+    // не-цифры, но нужна только первая из них
+    std::uint64_t nonDigitBytes(std::uint64_t chunk) {
+        const std::uint64_t high = repeatByte(0xF0);
 
-    if (it != nameTable.end())
-        pointerRegister = it->second;
-    else {
-        auto newIndex = static_cast<unsigned>(nameTable.size());
-        nameTable[name] = newIndex;
-        pointerRegister = newIndex;
+        return ((chunk & high) ^ repeatByte('0')) | (((chunk + repeatByte(6)) & high) ^ repeatByte('0'));
+    }
+
+    // Восемь цифр ASCII в одном слове (первая цифра — младший байт): пары, четвёрки, восьмёрка
+    std::uint64_t eightDigitsValue(std::uint64_t chunk) {
+        chunk = (chunk & repeatByte(0x0F)) * (256 * 10 + 1) >> 8;
+        chunk = (chunk & 0x00FF00FF00FF00FFULL) * (65536 * 100 + 1) >> 16;
+
+        return (chunk & 0x0000FFFF0000FFFFULL) * (4294967296ULL * 10000 + 1) >> 32;
+    }
+
+    constexpr std::array<std::uint64_t, 9> powersOfTen = {
+        1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000
+    };
+
+    // Цифры разбираются словами только при младшем порядке байтов, иначе по одной
+    constexpr bool wordParsing = std::endian::native == std::endian::little;
+}
+
+// Ключевые слова и переходы автомата после их последней буквы.
+// Новое ключевое слово достаточно добавить сюда: дерево для распознавания строится при компиляции
+constexpr Lexer::Keyword Lexer::keywords[] = {
+    {"push", LexemeClass::PUSH, &Lexer::E1a},
+    {"pop", LexemeClass::POP, &Lexer::E3a},
+    {"jmp", LexemeClass::JMP, &Lexer::E2b},
+    {"ji", LexemeClass::JI, &Lexer::E2a},
+    {"read", LexemeClass::READ, &Lexer::C1c},
+    {"write", LexemeClass::WRITE, &Lexer::C1d},
+    {"end", LexemeClass::END, &Lexer::C1b},
+    {"vadd", LexemeClass::VADD, &Lexer::handleVCommand},
+    {"vsub", LexemeClass::VSUB, &Lexer::handleVSubCommand},
+    {"vmul", LexemeClass::VMUL, &Lexer::handleVMulCommand},
+    {"vdiv", LexemeClass::VDIV, &Lexer::handleVDivCommand},
+    {"vmod", LexemeClass::VMOD, &Lexer::handleVModCommand},
+    {"vdot", LexemeClass::VDOT, &Lexer::handleVDotCommand},
+    {"vconcat", LexemeClass::VCONCAT, &Lexer::handleVConcatCommand},
+    {"vlshift", LexemeClass::VLSHIFT, &Lexer::handleVLShiftCommand},
+    {"vrshift", LexemeClass::VRSHIFT, &Lexer::handleVRShiftCommand},
+    {"mload", LexemeClass::MLOAD, &Lexer::handleMLoadCommand},
+    {"mmul", LexemeClass::MMUL, &Lexer::handleMMulCommand},
+    {"mtrans", LexemeClass::MTRANS, &Lexer::handleMTransCommand},
+    {"mrow", LexemeClass::MROW, &Lexer::handleMRowCommand},
+    {"mcol", LexemeClass::MCOL, &Lexer::handleMColCommand},
+    {"vsort", LexemeClass::VSORT, &Lexer::handleVSortCommand},
+    {"vfind", LexemeClass::VFIND, &Lexer::handleVFindCommand},
+    {"vuniq", LexemeClass::VUNIQ, &Lexer::handleVUniqCommand},
+    {"vget", LexemeClass::VGET, &Lexer::handleVGetCommand},
+    {"vset", LexemeClass::VSET, &Lexer::handleVSetCommand},
+    {"vgather", LexemeClass::VGATHER, &Lexer::handleVGatherCommand},
+    {"vscatter", LexemeClass::VSCATTER, &Lexer::handleVScatterCommand}
+};
+
+namespace {
+    constexpr std::size_t alphabetSize = 26;
+
+    // Префиксное дерево ключевых слов: узел 0 — корень, переход 0 означает отсутствие продолжения
+    template<std::size_t Capacity>
+    struct KeywordTrie {
+        struct Node {
+            std::array<short, alphabetSize> next{};
+            short keyword = -1; // номер ключевого слова, которое заканчивается в узле
+        };
+
+        std::array<Node, Capacity> nodes{};
+    };
+
+    template<typename Keyword, std::size_t Count>
+    consteval std::size_t trieCapacity(const Keyword (&keywords)[Count]) {
+        std::size_t capacity = 1;
+        for (const Keyword &keyword: keywords)
+            capacity += keyword.text.size();
+
+        return capacity;
+    }
+
+    template<std::size_t Capacity, typename Keyword, std::size_t Count>
+    consteval KeywordTrie<Capacity> buildKeywordTrie(const Keyword (&keywords)[Count]) {
+        KeywordTrie<Capacity> trie{};
+        short used = 1;
+
+        for (std::size_t index = 0; index < Count; ++index) {
+            short node = 0;
+            for (const char letter: keywords[index].text) {
+                if (letter < 'a' || letter > 'z')
+                    throw "ключевое слово должно состоять из строчных латинских букв";
+
+                short &next = trie.nodes[static_cast<std::size_t>(node)].next[static_cast<std::size_t>(letter - 'a')];
+                if (next == 0)
+                    next = used++;
+                node = next;
+            }
+
+            if (trie.nodes[static_cast<std::size_t>(node)].keyword != -1)
+                throw "ключевое слово повторяется";
+
+            trie.nodes[static_cast<std::size_t>(node)].keyword = static_cast<short>(index);
+        }
+
+        return trie;
     }
 }
 
-void addConstant(unsigned short &pointerRegister, unsigned numberRegister, bool constantFlag) {
+const Lexer::Keyword *Lexer::nextKeyword(short &node, char letter) {
+    static constexpr auto trie = buildKeywordTrie<trieCapacity(keywords)>(keywords);
+
+    if (node == noKeyword || letter < 'a' || letter > 'z') {
+        node = noKeyword;
+        return nullptr;
+    }
+
+    const auto &current = trie.nodes[static_cast<std::size_t>(node)];
+    const short next = current.next[static_cast<std::size_t>(letter - 'a')];
+    if (next == 0) {
+        node = noKeyword;
+        return nullptr;
+    }
+
+    node = next;
+    const short index = trie.nodes[static_cast<std::size_t>(next)].keyword;
+
+    return index == -1 ? nullptr : &keywords[index];
+}
+
+const Lexer::Keyword *Lexer::findKeyword(std::string_view name) {
+    short node = 0;
+    const Keyword *keyword = nullptr;
+    for (const char letter: name)
+        keyword = nextKeyword(node, letter);
+
+    return keyword;
+}
+
+
+void Lexer::addNameToTable(std::string_view name) {
+    // Имя, записанное в тексте как есть, хранится ссылкой на текст без копирования
+    const bool borrowed = identifierStart && static_cast<std::size_t>(sourceEnd - identifierStart) >= name.size() &&
+                          std::string_view(identifierStart, name.size()) == name;
+
+    pointerRegister = result.nameTable.intern(borrowed ? std::string_view(identifierStart, name.size()) : name, borrowed);
+}
+
+void Lexer::addConstant(unsigned numberRegister, bool constantFlag) {
     if (constantFlag == 0)
         return;
 
-    constantTable.insert(numberRegister);
-    pointerRegister = static_cast<unsigned short>(constantTable.size() - 1);
+    pointerRegister = result.constantTable.intern(numberRegister);
 }
 
-void createLexeme(LexemeClass classRegister, unsigned pointerRegister, unsigned numberRegister,
+void Lexer::createLexeme(LexemeClass classRegister, unsigned pointerRegister, unsigned numberRegister,
     unsigned relationRegister, unsigned lineNumber) {
     if (classRegister == LexemeClass::COMMENT)
         return;
@@ -43,6 +245,10 @@ void createLexeme(LexemeClass classRegister, unsigned pointerRegister, unsigned
             newLexeme.value = relationRegister;
         break;
         case LexemeClass::CONSTANT:
+            // Операнд push уже добавлен в таблицу констант, лексема хранит его индекс
+            newLexeme.value = constantFlag ? pointerRegister : numberRegister;
+        break;
+        case LexemeClass::VECTOR:
             newLexeme.value = numberRegister;
         break;
         case LexemeClass::VARIABLE:
@@ -59,74 +265,70 @@ void createLexeme(LexemeClass classRegister, unsigned pointerRegister, unsigned
         case LexemeClass::VCONCAT:
         case LexemeClass::VLSHIFT:
         case LexemeClass::VRSHIFT:
+        case LexemeClass::MLOAD:
+        case LexemeClass::MMUL:
+        case LexemeClass::MTRANS:
+        case LexemeClass::MROW:
+        case LexemeClass::MCOL:
+        case LexemeClass::VSORT:
+        case LexemeClass::VFIND:
+        case LexemeClass::VUNIQ:
+        case LexemeClass::VGET:
+        case LexemeClass::VSET:
+        case LexemeClass::VGATHER:
+        case LexemeClass::VSCATTER:
             newLexeme.value = static_cast<unsigned>(classRegister);
         break;
         default:
-            newLexeme.value = pointerRegister;
+            newLexeme.value = 0;
         break;
     }
 
-    lexemes.push_back(newLexeme);
+    if (streaming)
+        pending.push_back(newLexeme);
+    else
+        result.lexemes.push_back(newLexeme);
 }
 
-SymbolicToken transliterator(int ch) {
-    static bool inComment = false;
+SymbolicToken Lexer::transliterator(int ch) {
+    if (ch == EOF)
+        return {SymbolicTokenClass::END_OF_FILE, 0};
 
-    SymbolicToken symbol{};
-    symbol.value = 0;
-
-    if (ch == ';') {
-        inComment = true;
-        symbol.tokenClass = SymbolicTokenClass::SEMICOLON;
-        symbol.value = static_cast<unsigned>(ch);
-        return symbol;
-    }
+    const auto byte = static_cast<unsigned char>(ch);
+    const SymbolicTokenClass tokenClass = characterClasses[byte];
 
-    if (ch == '\n') {
+    if (tokenClass == SymbolicTokenClass::END_OF_LINE) {
         inComment = false;
-        symbol.tokenClass = SymbolicTokenClass::END_OF_LINE;
-        return symbol;
-    }
-
-    if (inComment) {
-        symbol.tokenClass = SymbolicTokenClass::SEMICOLON;
-        symbol.value = static_cast<unsigned>(ch);
-        return symbol;
+        return {tokenClass, 0};
     }
 
-    if (isalpha(ch)) {
-        symbol.tokenClass = SymbolicTokenClass::LETTER;
-        symbol.value = static_cast<unsigned>(std::tolower(ch));
-    } else if (isdigit(ch)) {
-        symbol.tokenClass = SymbolicTokenClass::DIGIT;
-        symbol.value = static_cast<unsigned>(ch - '0');
-    } else if (ch == '+' || ch == '-' || ch == '*' || ch == '/' || ch == '%') {
-        symbol.tokenClass = SymbolicTokenClass::ARITHMETIC_OPERATION;
-        symbol.value = static_cast<unsigned>(ch);
-    } else if (ch == '=' || ch == '!' || ch == '<' || ch == '>') {
-        if (ch == '<' && file.peek() == '<') {
-            file.get();
-            symbol.tokenClass = SymbolicTokenClass::VECTOR_SYMBOL;
-            symbol.value = static_cast<unsigned>(LexemeCodes::VECTOR_START);
-        } else if (ch == '>' && file.peek() == '>') {
-            file.get();
-            symbol.tokenClass = SymbolicTokenClass::VECTOR_SYMBOL;
-            symbol.value = static_cast<unsigned>(LexemeCodes::VECTOR_END);
-        } else {
-            symbol.tokenClass = SymbolicTokenClass::COMPARISON_OPERATION;
-            symbol.value = static_cast<unsigned>(ch);
-        }
-    } else if (ch == ',') {
-        symbol.tokenClass = SymbolicTokenClass::COMMA;
-        symbol.value = static_cast<unsigned>(ch);
-    } else if (ch == ' ' || ch == '\t')
-        symbol.tokenClass = SymbolicTokenClass::SPACE_OR_TAB;
-    else if (ch == EOF)
-        symbol.tokenClass = SymbolicTokenClass::END_OF_FILE;
-    else
-        symbol.tokenClass = SymbolicTokenClass::ERROR;
+    if (tokenClass == SymbolicTokenClass::SEMICOLON)
+        inComment = true;
 
-    return symbol;
+    if (inComment)
+        return {SymbolicTokenClass::SEMICOLON, byte};
+
+    switch (tokenClass) {
+        case SymbolicTokenClass::LETTER:
+            return {tokenClass, static_cast<unsigned>(byte | 0x20)}; // нижний регистр
+        case SymbolicTokenClass::DIGIT:
+            return {tokenClass, static_cast<unsigned>(byte - '0')};
+        case SymbolicTokenClass::COMPARISON_OPERATION:
+            if (byte == '<' && sourceCursor != sourceEnd && *sourceCursor == '<') {
+                ++sourceCursor;
+                return {SymbolicTokenClass::VECTOR_SYMBOL, static_cast<unsigned>(LexemeCodes::VECTOR_START)};
+            }
+            if (byte == '>' && sourceCursor != sourceEnd && *sourceCursor == '>') {
+                ++sourceCursor;
+                return {SymbolicTokenClass::VECTOR_SYMBOL, static_cast<unsigned>(LexemeCodes::VECTOR_END)};
+            }
+            return {tokenClass, byte};
+        case SymbolicTokenClass::ARITHMETIC_OPERATION:
+        case SymbolicTokenClass::COMMA:
+            return {tokenClass, byte};
+        default:
+            return {tokenClass, 0};
+    }
 }
 
 short processRelation(char first, char second) {
@@ -157,28 +359,23 @@ short processRelation(char first, char second) {
     return -1;
 }
 
-void addVariable() {
+void Lexer::addVariable() {
     if (variableRegister.find('<') != std::string::npos ||
         variableRegister.find('>') != std::string::npos ||
         variableRegister.find(',') != std::string::npos) {
         return;
     }
 
-    static const std::array<std::string, 16> keyWords = {
-        "push", "pop", "jmp", "ji", "read", "write", "end", "vadd", "vsub", "vmul", "vdiv", "vmod", "vdot", "vconcat",
-        "vlshift", "vrshift"
-    };
-
-    for (const auto &keyWord: keyWords)
-        if (variableRegister == keyWord) {
-            std::cerr << "Имя переменной совпадает с одним из ключевых слов" << std::endl;
-            return;
-        }
+    // Лексема всё равно ссылается на имя: иначе её значение осталось бы от предыдущей строки
+    // и зависело бы от того, с какой строки начат разбор
+    if (findKeyword(variableRegister))
+        report(lineNumber, "имя переменной совпадает с одним из ключевых слов");
 
     addNameToTable(variableRegister);
 }
 
-std::string getLexemeValueString(LexemeClass lexemeClass, unsigned value) {
+std::string getLexemeValueString(const LexResult &result, LexemeClass lexemeClass, unsigned value,
+                                 LexemeClass previousClass) {
         switch (lexemeClass) {
         case LexemeClass::PUSH: return "PUSH";
         case LexemeClass::POP: return "POP";
@@ -191,11 +388,23 @@ std::string getLexemeValueString(LexemeClass lexemeClass, unsigned value) {
         case LexemeClass::GREATER_EQUAL: return ">=";
         case LexemeClass::LESS_EQUAL: return "<=";
         case LexemeClass::VARIABLE:
-            for (const auto &[name, index]: nameTable)
-                if (index == value)
-                    return name;
+            if (value < result.nameTable.size())
+                return std::string(result.nameTable.name(value));
+            return std::to_string(value);
+        case LexemeClass::CONSTANT:
+            if (isPooledConstant(previousClass, lexemeClass) && value < result.constantTable.size())
+                return std::to_string(result.constantTable.value(value));
             return std::to_string(value);
-        case LexemeClass::CONSTANT: return std::to_string(value);
+        case LexemeClass::VECTOR: {
+            if (value >= result.vectors.size())
+                return std::to_string(value);
+
+            std::string text = "<<";
+            for (std::size_t i = 0; i < result.vectors[value].size(); ++i)
+                text += (i == 0 ? "" : ", ") + std::to_string(result.vectors[value][i]);
+
+            return text + ">>";
+        }
         case LexemeClass::JMP: return "JMP";
         case LexemeClass::JI: return "JI";
         case LexemeClass::READ: return "READ";
@@ -221,44 +430,56 @@ std::string getLexemeValueString(LexemeClass lexemeClass, unsigned value) {
         case LexemeClass::VCONCAT: return "VCONCAT";
         case LexemeClass::VLSHIFT: return "VLSHIFT";
         case LexemeClass::VRSHIFT: return "VRSHIFT";
+        case LexemeClass::MLOAD: return "MLOAD";
+        case LexemeClass::MMUL: return "MMUL";
+        case LexemeClass::MTRANS: return "MTRANS";
+        case LexemeClass::MROW: return "MROW";
+        case LexemeClass::MCOL: return "MCOL";
+        case LexemeClass::VSORT: return "VSORT";
+        case LexemeClass::VFIND: return "VFIND";
+        case LexemeClass::VUNIQ: return "VUNIQ";
+        case LexemeClass::VGET: return "VGET";
+        case LexemeClass::VSET: return "VSET";
+        case LexemeClass::VGATHER: return "VGATHER";
+        case LexemeClass::VSCATTER: return "VSCATTER";
         default: return "UNKNOWN";
     }
 }
 
-States A1() {
+States Lexer::A1() {
     if (globalSymbol.tokenClass == SymbolicTokenClass::SPACE_OR_TAB)
         return States::states_A1;
 
     return ERROR1(lineNumber);
 }
 
-States A1a() {
+States Lexer::A1a() {
     createLexeme(static_cast<LexemeClass>(classRegister), pointerRegister, numberRegister, static_cast<unsigned>(relationRegister), lineNumber);
     lineNumber++;
 
     return States::states_A1;
 }
 
-States A1b() {
+States Lexer::A1b() {
     lineNumber++;
 
     return States::states_A1;
 }
 
-States A2() {
+States Lexer::A2() {
     if (globalSymbol.tokenClass == SymbolicTokenClass::SPACE_OR_TAB)
         return States::states_A2;
 
     return ERROR1(lineNumber);
 }
 
-States A2a() {
+States Lexer::A2a() {
     lineNumber++;
 
     return States::states_A2;
 }
 
-States A2b() {
+States Lexer::A2b() {
     createLexeme(static_cast<LexemeClass>(classRegister), pointerRegister, numberRegister,
              static_cast<unsigned>(relationRegister), lineNumber);
     lineNumber++;
@@ -266,8 +487,8 @@ States A2b() {
     return States::states_A2;
 }
 
-States A2c() {
-    constantTable.insert(numberRegister);
+States Lexer::A2c() {
+    addConstant(numberRegister, constantFlag);
     createLexeme(static_cast<LexemeClass>(classRegister), pointerRegister, numberRegister,
                  static_cast<unsigned>(relationRegister), lineNumber);
     lineNumber++;
@@ -275,7 +496,7 @@ States A2c() {
     return States::states_A2;
 }
 
-States A2d() {
+States Lexer::A2d() {
     addVariable();
     createLexeme(static_cast<LexemeClass>(classRegister), pointerRegister, numberRegister,
                  static_cast<unsigned>(relationRegister), lineNumber);
@@ -284,7 +505,7 @@ States A2d() {
     return States::states_A2;
 }
 
-States A2e() {
+States Lexer::A2e() {
     if (relationRegister == '!')
         return ERROR1(lineNumber);
 
@@ -295,7 +516,7 @@ States A2e() {
     return States::states_A2;
 }
 
-States A2f() {
+States Lexer::A2f() {
     classRegister = static_cast<unsigned short>(LexemeClass::ERROR);
     createLexeme(static_cast<LexemeClass>(classRegister), pointerRegister, numberRegister,
                  static_cast<unsigned>(relationRegister), lineNumber);
@@ -304,34 +525,18 @@ States A2f() {
     return States::states_A2;
 }
 
-States B1a() {
-    char currentSymbol = static_cast<char>(std::tolower(static_cast<int>(globalSymbol.value)));
+States Lexer::B1a() {
+    const auto currentSymbol = static_cast<char>(globalSymbol.value);
     variableRegister = std::string(1, currentSymbol);
+    detectionRegister = 0;
 
-    auto it = initialMap.find(currentSymbol);
-    if (it != initialMap.end()) {
-        std::visit([]<typename T0>(T0 &&arg) {
-            using T = std::decay_t<T0>;
-            if constexpr (std::is_arithmetic_v<T>)
-                detectionRegister = static_cast<short>(arg);
-            else
-                detectionRegister = -1;
-        }, it->second);
-    }
-
-    if (detectionRegister == 0)
-        return ERROR1(lineNumber);
-
-    return States::states_B1;
-}
-
-States B1b() {
-    detectionRegister++;
+    if (const Keyword *keyword = nextKeyword(detectionRegister, currentSymbol))
+        return (this->*keyword->procedure)();
 
     return States::states_B1;
 }
 
-States C1() {
+States Lexer::C1() {
     if (globalSymbol.tokenClass == SymbolicTokenClass::SPACE_OR_TAB)
         return States::states_C1;
 
@@ -343,7 +548,7 @@ States C1() {
     return ERROR1(lineNumber);
 }
 
-States C1a() {
+States Lexer::C1a() {
     switch (static_cast<char>(globalSymbol.value)) {
         case '+':
             classRegister = static_cast<unsigned short>(LexemeClass::ADD);
@@ -370,7 +575,7 @@ States C1a() {
     return States::states_C1;
 }
 
-States C1b() {
+States Lexer::C1b() {
     classRegister = static_cast<unsigned short>(LexemeClass::END);
     createLexeme(static_cast<LexemeClass>(classRegister),
                  pointerRegister,
@@ -381,7 +586,7 @@ States C1b() {
     return States::states_C1;
 }
 
-States C1c() {
+States Lexer::C1c() {
     classRegister = static_cast<unsigned short>(LexemeClass::READ);
     createLexeme(static_cast<LexemeClass>(classRegister), pointerRegister, numberRegister,
                  static_cast<unsigned>(relationRegister),
@@ -391,7 +596,7 @@ States C1c() {
     return States::states_C1;
 }
 
-States C1d() {
+States Lexer::C1d() {
     classRegister = static_cast<unsigned short>(LexemeClass::WRITE);
     createLexeme(static_cast<LexemeClass>(classRegister),
                  pointerRegister,
@@ -402,10 +607,8 @@ States C1d() {
     return States::states_C1;
 }
 
-States C1e() {
-    auto localPointerRegister = static_cast<unsigned short>(pointerRegister);
-    addConstant(localPointerRegister, numberRegister, constantFlag);
-    pointerRegister = localPointerRegister;
+States Lexer::C1e() {
+    addConstant(numberRegister, constantFlag);
 
     createLexeme(static_cast<LexemeClass>(classRegister), pointerRegister, numberRegister,
                  static_cast<unsigned>(relationRegister),
@@ -415,7 +618,7 @@ States C1e() {
     return States::states_C1;
 }
 
-States C1f() {
+States Lexer::C1f() {
     addVariable();
     createLexeme(static_cast<LexemeClass>(classRegister), pointerRegister, numberRegister,
                  static_cast<unsigned>(relationRegister),
@@ -425,7 +628,7 @@ States C1f() {
     return States::states_C1;
 }
 
-States C1g() {
+States Lexer::C1g() {
     if (relationRegister == '!')
         return ERROR1(lineNumber);
 
@@ -437,7 +640,7 @@ States C1g() {
     return States::states_C1;
 }
 
-States C1h() {
+States Lexer::C1h() {
     char currentSymbol = static_cast<char>(globalSymbol.value);
     short relationValue = processRelation(relationRegister, currentSymbol);
 
@@ -473,7 +676,7 @@ States C1h() {
     return States::states_C1;
 }
 
-States D1a() {
+States Lexer::D1a() {
     relationRegister = static_cast<char>(globalSymbol.value);
 
     switch (relationRegister) {
@@ -496,7 +699,7 @@ States D1a() {
     return States::states_D1;
 }
 
-States E1a() {
+States Lexer::E1a() {
     classRegister = static_cast<unsigned short>(LexemeClass::PUSH);
     constantFlag = true;
     createLexeme(static_cast<LexemeClass>(classRegister), pointerRegister, numberRegister, 0, lineNumber);
@@ -504,7 +707,7 @@ States E1a() {
     return States::states_E1;
 }
 
-States E2a() {
+States Lexer::E2a() {
     classRegister = static_cast<unsigned short>(LexemeClass::JI);
     constantFlag = false;
     createLexeme(static_cast<LexemeClass>(classRegister), pointerRegister, numberRegister, 0, lineNumber);
@@ -512,7 +715,7 @@ States E2a() {
     return States::states_E2;
 }
 
-States E2b() {
+States Lexer::E2b() {
     classRegister = static_cast<unsigned short>(LexemeClass::JMP);
     constantFlag = false;
     createLexeme(static_cast<LexemeClass>(classRegister), pointerRegister, numberRegister, 0, lineNumber);
@@ -520,14 +723,14 @@ States E2b() {
     return States::states_E2;
 }
 
-States E3a() {
+States Lexer::E3a() {
     classRegister = static_cast<unsigned short>(LexemeClass::POP);
     createLexeme(static_cast<LexemeClass>(classRegister), pointerRegister, numberRegister, 0, lineNumber);
 
     return States::states_E3;
 }
 
-States F1() {
+States Lexer::F1() {
     if (globalSymbol.tokenClass == SymbolicTokenClass::SPACE_OR_TAB)
         return States::states_F1;
 
@@ -540,7 +743,7 @@ States F1() {
     return ERROR1(lineNumber);
 }
 
-States F2() {
+States Lexer::F2() {
     if (globalSymbol.tokenClass == SymbolicTokenClass::SPACE_OR_TAB)
         return States::states_F2;
     if (globalSymbol.tokenClass == SymbolicTokenClass::DIGIT)
@@ -549,7 +752,7 @@ States F2() {
     return ERROR1(lineNumber);
 }
 
-States F3() {
+States Lexer::F3() {
     if (globalSymbol.tokenClass == SymbolicTokenClass::SPACE_OR_TAB)
         return States::states_F3;
 
@@ -559,183 +762,118 @@ States F3() {
     return ERROR1(lineNumber);
 }
 
-States G1a() {
-    numberRegister = globalSymbol.value;
+States Lexer::G1a() {
+    numberRegister = 0;
     classRegister = static_cast<unsigned short>(LexemeClass::CONSTANT);
+    if (!readNumber())
+        return numberOverflow();
 
     return States::states_G1;
 }
 
-States G1b() {
-    numberRegister = 10 * numberRegister + globalSymbol.value;
+States Lexer::G1b() {
+    if (!readNumber())
+        return numberOverflow();
 
     return States::states_G1;
 }
 
-States H1a() {
-    variableRegister = static_cast<char>(globalSymbol.value);
+States Lexer::H1a() {
     classRegister = static_cast<unsigned short>(LexemeCodes::VARIABLE);
     variableRegister = std::string(1, static_cast<char>(globalSymbol.value));
+    identifierStart = sourceCursor - 1;
+    detectionRegister = 0;
+    nextKeyword(detectionRegister, static_cast<char>(globalSymbol.value));
 
     return States::states_H1;
 }
 
-States H1b() {
-    variableRegister += static_cast<char>(globalSymbol.value);
-
-    if (variableRegister == "vadd") {
-        classRegister = static_cast<unsigned short>(LexemeClass::VADD);
-        createLexeme(LexemeClass::VADD, 0, 0, 0, lineNumber);
-        return States::states_C1;
-    }
-
-    if (variableRegister == "vsub") {
-        classRegister = static_cast<unsigned short>(LexemeClass::VSUB);
-        createLexeme(LexemeClass::VSUB, 0, 0, 0, lineNumber);
-        return States::states_C1;
-    }
-
-    if (variableRegister == "vmul") {
-        classRegister = static_cast<unsigned short>(LexemeClass::VMUL);
-        createLexeme(LexemeClass::VMUL, 0, 0, 0, lineNumber);
-        return States::states_C1;
-    }
-
-    if (variableRegister == "vdiv") {
-        classRegister = static_cast<unsigned short>(LexemeClass::VDIV);
-        createLexeme(LexemeClass::VDIV, 0, 0, 0, lineNumber);
-        return States::states_C1;
-    }
-
-    if (variableRegister == "vmod") {
-        classRegister = static_cast<unsigned short>(LexemeClass::VMOD);
-        createLexeme(LexemeClass::VMOD, 0, 0, 0, lineNumber);
-        return States::states_C1;
-    }
-
-    if (variableRegister == "vdot") {
-        classRegister = static_cast<unsigned short>(LexemeClass::VDOT);
-        createLexeme(LexemeClass::VDOT, 0, 0, 0, lineNumber);
-        return States::states_C1;
-    }
-
-    if (variableRegister == "vconcat") {
-        classRegister = static_cast<unsigned short>(LexemeClass::VCONCAT);
-        createLexeme(LexemeClass::VCONCAT, 0, 0, 0, lineNumber);
-        return States::states_C1;
-    }
-
-    if (variableRegister == "vlshift") {
-        classRegister = static_cast<unsigned short>(LexemeClass::VLSHIFT);
-        createLexeme(LexemeClass::VLSHIFT, 0, 0, 0, lineNumber);
-        return States::states_C1;
-    }
+States Lexer::H1b() {
+    // У цифр символьная лексема хранит значение, а не код символа
+    if (globalSymbol.tokenClass == SymbolicTokenClass::DIGIT)
+        variableRegister += static_cast<char>('0' + globalSymbol.value);
+    else
+        variableRegister += static_cast<char>(globalSymbol.value);
 
-    if (variableRegister == "vrshift") {
-        classRegister = static_cast<unsigned short>(LexemeClass::VRSHIFT);
-        createLexeme(LexemeClass::VRSHIFT, 0, 0, 0, lineNumber);
-        return States::states_C1;
-    }
+    // Имя поэлементной векторной операции в операнде читается как сама операция
+    if (const Keyword *keyword = nextKeyword(detectionRegister, static_cast<char>(globalSymbol.value));
+        keyword && keyword->lexemeClass >= LexemeClass::VADD && keyword->lexemeClass <= LexemeClass::VRSHIFT)
+        return (this->*keyword->procedure)();
 
     return States::states_H1;
 }
 
-States I1() {
+States Lexer::I1() {
     return States::states_I1;
 }
 
-States I1a() {
+States Lexer::I1a() {
     classRegister = static_cast<unsigned short>(LexemeClass::COMMENT);
-    globalComment.clear();
 
     return States::states_I1;
 }
 
-States I2() {
-    globalComment += static_cast<char>(globalSymbol.value);
-
+States Lexer::I2() {
     return States::states_I2;
 }
 
-States I2a() {
-    try {
-        if (globalComment.empty() || globalComment[0] == ' ')
-            classRegister = static_cast<unsigned short>(LexemeClass::COMMENT);
-        else {
-            if (std::ranges::all_of(globalComment, isdigit))
-                classRegister = static_cast<unsigned short>(std::stoi(globalComment));
-            else
-                classRegister = static_cast<unsigned short>(LexemeClass::COMMENT);
-        }
-    } catch (const std::exception &e) {
-        std::cerr << "Ошибка при преобразовании строки в число: " << e.what() << std::endl;
-        classRegister = static_cast<unsigned short>(LexemeClass::COMMENT);
-    }
+States Lexer::I2a() {
+    // Комментарий не порождает лексем и не влияет на следующие строки
+    classRegister = static_cast<unsigned short>(LexemeClass::COMMENT);
 
     return States::states_I2;
 }
 
-States I2b() {
-    auto localPointerRegister = static_cast<unsigned short>(pointerRegister);
-    addConstant(localPointerRegister, numberRegister, constantFlag);
-    pointerRegister = localPointerRegister;
+States Lexer::I2b() {
+    addConstant(numberRegister, constantFlag);
     createLexeme(static_cast<LexemeClass>(classRegister), pointerRegister, numberRegister, static_cast<unsigned>(relationRegister), lineNumber);
-    classRegister = static_cast<unsigned short>(std::stoi(globalComment));
+    classRegister = static_cast<unsigned short>(LexemeClass::COMMENT);
 
     return States::states_I2;
 }
 
-States I2c() {
+States Lexer::I2c() {
     addVariable();
     createLexeme(static_cast<LexemeClass>(classRegister), pointerRegister, numberRegister, static_cast<unsigned>(relationRegister), lineNumber);
-    classRegister = static_cast<unsigned short>(std::stoi(globalComment));
+    classRegister = static_cast<unsigned short>(LexemeClass::COMMENT);
 
     return States::states_I2;
 }
 
-States I2d() {
+States Lexer::I2d() {
     if (relationRegister == '!')
         return ERROR1(lineNumber);
 
     createLexeme(static_cast<LexemeClass>(classRegister), pointerRegister, numberRegister, static_cast<unsigned>(relationRegister), lineNumber);
-    classRegister = static_cast<unsigned short>(std::stoi(globalComment));
+    classRegister = static_cast<unsigned short>(LexemeClass::COMMENT);
 
     return States::states_I2;
 }
 
-States J1() {
+States Lexer::J1() {
     return States::states_J1;
 }
 
-States M1() {
+States Lexer::M1() {
     if (!globalSymbol.value)
         return ERROR1(lineNumber);
 
-    char currentSymbol = static_cast<char>(std::tolower(static_cast<int>(globalSymbol.value)));
-
-    while (true) {
-        for (const auto &[value, symbol, optionalValue, procedure]: vectorOfAlternatives) {
-            if (static_cast<unsigned long>(detectionRegister) == value) {
-                if (symbol == currentSymbol) {
-                    if (procedure)
-                        return procedure();
-                } else if (optionalValue.has_value())
-                    detectionRegister = static_cast<short>(optionalValue.value());
-            }
-        }
-
-        if (detectionRegister == 0)
-            return ERROR1(lineNumber);
+    const Keyword *keyword = nextKeyword(detectionRegister, static_cast<char>(globalSymbol.value));
+    if (keyword)
+        return (this->*keyword->procedure)();
 
+    // Ни одно ключевое слово так не продолжается: следующий символ даст ошибку
+    if (detectionRegister == noKeyword)
         return States::states_M1;
-    }
+
+    return States::states_B1;
 }
 
-States V1() {
+States Lexer::V1() {
     if (globalSymbol.tokenClass == SymbolicTokenClass::DIGIT) {
-        numberRegister = globalSymbol.value;
+        numberRegister = 0;
         classRegister = static_cast<unsigned short>(LexemeClass::CONSTANT);
-        return States::states_V2;
+        return readNumber() ? States::states_V2 : numberOverflow();
     }
 
     if (globalSymbol.tokenClass == SymbolicTokenClass::SPACE_OR_TAB)
@@ -744,110 +882,188 @@ States V1() {
     return ERROR1(lineNumber);
 }
 
-States V2() {
-    if (globalSymbol.tokenClass == SymbolicTokenClass::DIGIT) {
-        numberRegister = 10 * numberRegister + globalSymbol.value;
-        return States::states_V2;
-    }
+States Lexer::V2() {
+    if (globalSymbol.tokenClass == SymbolicTokenClass::DIGIT)
+        return readNumber() ? States::states_V2 : numberOverflow();
 
     if (globalSymbol.tokenClass == SymbolicTokenClass::COMMA) {
         currentVector.push_back(numberRegister);
-        createLexeme(LexemeClass::CONSTANT, 0, numberRegister, 0, lineNumber);
-        createLexeme(LexemeClass::COMMA, 0, 0, 0, lineNumber);
         numberRegister = 0;
         return States::states_V1;
     }
 
     if (globalSymbol.tokenClass == SymbolicTokenClass::VECTOR_SYMBOL && globalSymbol.value == static_cast<unsigned>(LexemeCodes::VECTOR_END)) {
+        // Литерал целиком становится одной лексемой со ссылкой на таблицу векторов
         currentVector.push_back(numberRegister);
-        vectors.push_back(currentVector);
+        result.vectors.push_back(std::move(currentVector));
         currentVector.clear();
 
-        createLexeme(LexemeClass::CONSTANT, 0, numberRegister, 0, lineNumber);
-        createLexeme(LexemeClass::VECTOR_END, 0, 0, 0, lineNumber);
+        createLexeme(LexemeClass::VECTOR, 0, static_cast<unsigned>(result.vectors.size() - 1), 0, lineNumber);
         return States::states_C1;
     }
 
     return ERROR1(lineNumber);
 }
 
-States handleVCommand() {
+States Lexer::handleVCommand() {
     classRegister = static_cast<unsigned short>(LexemeClass::VADD);
     createLexeme(LexemeClass::VADD, 0, 0, 0, lineNumber);
 
     return States::states_C1;
 }
 
-States handleVectorStart() {
-    createLexeme(LexemeClass::VECTOR_START, 0, 0, 0, lineNumber);
-
+States Lexer::handleVectorStart() {
     return States::states_V1;
 }
 
-States handleVSubCommand() {
+States Lexer::handleVSubCommand() {
     classRegister = static_cast<unsigned short>(LexemeClass::VSUB);
     createLexeme(LexemeClass::VSUB, 0, 0, 0, lineNumber);
 
     return States::states_C1;
 }
 
-States handleVMulCommand() {
+States Lexer::handleVMulCommand() {
     classRegister = static_cast<unsigned short>(LexemeClass::VMUL);
     createLexeme(LexemeClass::VMUL, 0, 0, 0, lineNumber);
 
     return States::states_C1;
 }
 
-States handleVDivCommand() {
+States Lexer::handleVDivCommand() {
     classRegister = static_cast<unsigned short>(LexemeClass::VDIV);
     createLexeme(LexemeClass::VDIV, 0, 0, 0, lineNumber);
 
     return States::states_C1;
 }
 
-States handleVModCommand() {
+States Lexer::handleVModCommand() {
     classRegister = static_cast<unsigned short>(LexemeClass::VMOD);
     createLexeme(LexemeClass::VMOD, 0, 0, 0, lineNumber);
 
     return States::states_C1;
 }
 
-States handleVDotCommand() {
+States Lexer::handleVDotCommand() {
     classRegister = static_cast<unsigned short>(LexemeClass::VDOT);
     createLexeme(LexemeClass::VDOT, 0, 0, 0, lineNumber);
 
     return States::states_C1;
 }
 
-States handleVConcatCommand() {
+States Lexer::handleVConcatCommand() {
     classRegister = static_cast<unsigned short>(LexemeClass::VCONCAT);
     createLexeme(LexemeClass::VCONCAT, 0, 0, 0, lineNumber);
 
     return States::states_C1;
 }
 
-States handleVLShiftCommand() {
+States Lexer::handleVLShiftCommand() {
     classRegister = static_cast<unsigned short>(LexemeClass::VLSHIFT);
     createLexeme(LexemeClass::VLSHIFT, 0, 0, 0, lineNumber);
 
     return States::states_C1;
 }
 
-States handleVRShiftCommand() {
+States Lexer::handleVRShiftCommand() {
     classRegister = static_cast<unsigned short>(LexemeClass::VRSHIFT);
     createLexeme(LexemeClass::VRSHIFT, 0, 0, 0, lineNumber);
 
     return States::states_C1;
 }
 
-States EXIT1() {
+States Lexer::handleMLoadCommand() {
+    classRegister = static_cast<unsigned short>(LexemeClass::MLOAD);
+    createLexeme(LexemeClass::MLOAD, 0, 0, 0, lineNumber);
+
+    return States::states_C1;
+}
+
+States Lexer::handleMMulCommand() {
+    classRegister = static_cast<unsigned short>(LexemeClass::MMUL);
+    createLexeme(LexemeClass::MMUL, 0, 0, 0, lineNumber);
+
+    return States::states_C1;
+}
+
+States Lexer::handleMTransCommand() {
+    classRegister = static_cast<unsigned short>(LexemeClass::MTRANS);
+    createLexeme(LexemeClass::MTRANS, 0, 0, 0, lineNumber);
+
+    return States::states_C1;
+}
+
+States Lexer::handleMRowCommand() {
+    classRegister = static_cast<unsigned short>(LexemeClass::MROW);
+    createLexeme(LexemeClass::MROW, 0, 0, 0, lineNumber);
+
+    return States::states_C1;
+}
+
+States Lexer::handleMColCommand() {
+    classRegister = static_cast<unsigned short>(LexemeClass::MCOL);
+    createLexeme(LexemeClass::MCOL, 0, 0, 0, lineNumber);
+
+    return States::states_C1;
+}
+
+States Lexer::handleVSortCommand() {
+    classRegister = static_cast<unsigned short>(LexemeClass::VSORT);
+    createLexeme(LexemeClass::VSORT, 0, 0, 0, lineNumber);
+
+    return States::states_C1;
+}
+
+States Lexer::handleVFindCommand() {
+    classRegister = static_cast<unsigned short>(LexemeClass::VFIND);
+    createLexeme(LexemeClass::VFIND, 0, 0, 0, lineNumber);
+
+    return States::states_C1;
+}
+
+States Lexer::handleVUniqCommand() {
+    classRegister = static_cast<unsigned short>(LexemeClass::VUNIQ);
+    createLexeme(LexemeClass::VUNIQ, 0, 0, 0, lineNumber);
+
+    return States::states_C1;
+}
+
+States Lexer::handleVGetCommand() {
+    classRegister = static_cast<unsigned short>(LexemeClass::VGET);
+    createLexeme(LexemeClass::VGET, 0, 0, 0, lineNumber);
+
+    return States::states_C1;
+}
+
+States Lexer::handleVSetCommand() {
+    classRegister = static_cast<unsigned short>(LexemeClass::VSET);
+    createLexeme(LexemeClass::VSET, 0, 0, 0, lineNumber);
+
+    return States::states_C1;
+}
+
+States Lexer::handleVGatherCommand() {
+    classRegister = static_cast<unsigned short>(LexemeClass::VGATHER);
+    createLexeme(LexemeClass::VGATHER, 0, 0, 0, lineNumber);
+
+    return States::states_C1;
+}
+
+States Lexer::handleVScatterCommand() {
+    classRegister = static_cast<unsigned short>(LexemeClass::VSCATTER);
+    createLexeme(LexemeClass::VSCATTER, 0, 0, 0, lineNumber);
+
+    return States::states_C1;
+}
+
+States Lexer::EXIT1() {
     classRegister = static_cast<unsigned short>(LexemeCodes::END_MARKER);
     createLexeme(static_cast<LexemeClass>(classRegister), pointerRegister, numberRegister, static_cast<unsigned>(relationRegister), lineNumber);
 
     return static_cast<States>(0);
 }
 
-States EXIT2() {
+States Lexer::EXIT2() {
     if (relationRegister == '!')
         return ERROR1(lineNumber);
 
@@ -858,10 +1074,8 @@ States EXIT2() {
     return static_cast<States>(0);
 }
 
-States EXIT3() {
-    auto localPointerRegister = static_cast<unsigned short>(pointerRegister);
-    addConstant(localPointerRegister, numberRegister, constantFlag);
-    pointerRegister = localPointerRegister;
+States Lexer::EXIT3() {
+    addConstant(numberRegister, constantFlag);
     createLexeme(static_cast<LexemeClass>(classRegister), pointerRegister, numberRegister, static_cast<unsigned>(relationRegister), lineNumber);
     classRegister = static_cast<unsigned short>(LexemeCodes::END_MARKER);
     createLexeme(static_cast<LexemeClass>(classRegister), pointerRegister, numberRegister, static_cast<unsigned>(relationRegister), lineNumber);
@@ -869,7 +1083,7 @@ States EXIT3() {
     return static_cast<States>(0);
 }
 
-States EXIT4() {
+States Lexer::EXIT4() {
     addVariable();
     createLexeme(static_cast<LexemeClass>(classRegister), pointerRegister, numberRegister, static_cast<unsigned>(relationRegister), lineNumber);
     classRegister = static_cast<unsigned short>(LexemeCodes::END_MARKER);
@@ -878,170 +1092,552 @@ States EXIT4() {
     return static_cast<States>(0);
 }
 
-States ERROR1(const unsigned &lineNumber) {
+bool Lexer::readNumber() {
+    // Первая цифра уже прочитана автоматом; серия дочитывается целиком прямо из текста
+    const char *digit = sourceCursor - 1;
+    std::uint64_t value = numberRegister;
+    constexpr std::uint64_t limit = std::numeric_limits<unsigned>::max();
+    bool overflow = false;
+
+    if constexpr (wordParsing) {
+        while (sourceEnd - digit >= 8) {
+            std::uint64_t chunk;
+            std::memcpy(&chunk, digit, sizeof chunk);
+
+            const std::uint64_t nonDigits = nonDigitBytes(chunk);
+            const auto count = nonDigits == 0 ? 8U : static_cast<unsigned>(std::countr_zero(nonDigits) / 8);
+            if (count > 0 && !overflow) {
+                // Неполная серия дополняется нулями слева, они не меняют значения
+                if (count < 8)
+                    chunk = chunk << (8 * (8 - count)) | repeatByte('0') >> (8 * count);
+                value = value * powersOfTen[count] + eightDigitsValue(chunk);
+                overflow = value > limit;
+            }
+
+            digit += count;
+            if (count < 8)
+                break;
+        }
+    }
+
+    for (; digit != sourceEnd && *digit >= '0' && *digit <= '9'; ++digit)
+        if (!overflow) {
+            value = value * 10 + static_cast<unsigned>(*digit - '0');
+            overflow = value > limit;
+        }
+
+    sourceCursor = digit;
+    numberRegister = static_cast<unsigned>(value);
+
+    return !overflow;
+}
+
+States Lexer::numberOverflow() {
+    report(lineNumber, "число не помещается в " + std::to_string(std::numeric_limits<unsigned>::digits) + " бит");
+
+    return ERROR1(lineNumber);
+}
+
+void Lexer::report(unsigned line, std::string message) {
+    result.diagnostics.push_back({line, std::move(message)});
+}
+
+States Lexer::errorTransition() {
+    return ERROR1(lineNumber);
+}
+
+States Lexer::ERROR1(const unsigned &lineNumber) {
     classRegister = static_cast<unsigned short>(LexemeClass::ERROR);
     createLexeme(static_cast<LexemeClass>(classRegister), pointerRegister, numberRegister, static_cast<unsigned>(relationRegister), lineNumber);
+    currentVector.clear();
+
+    // Ошибка на конце строки не должна поглощать следующую строку
+    if (globalSymbol.tokenClass == SymbolicTokenClass::END_OF_LINE) {
+        this->lineNumber++;
+
+        return States::states_A2;
+    }
 
     return States::states_J1;
 }
 
-TransitionTable initializeTable() {
+consteval Lexer::TransitionTable Lexer::initializeTable() {
     TransitionTable table{};
     for (auto &row: table)
-        std::ranges::fill(row, []() -> States { return ERROR1(lineNumber); });
-
-    table[static_cast<std::size_t>(States::states_A1)][static_cast<std::size_t>(SymbolicTokenClass::LETTER)] = B1a;
-    table[static_cast<std::size_t>(States::states_A1)][static_cast<std::size_t>(SymbolicTokenClass::ARITHMETIC_OPERATION)] = C1a;
-    table[static_cast<std::size_t>(States::states_A1)][static_cast<std::size_t>(SymbolicTokenClass::COMPARISON_OPERATION)] = D1a;
-    table[static_cast<std::size_t>(States::states_A1)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = A1;
-    table[static_cast<std::size_t>(States::states_A1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = A1b;
-    table[static_cast<std::size_t>(States::states_A1)][static_cast<std::size_t>(SymbolicTokenClass::SEMICOLON)] = I1a;
-
-    table[static_cast<std::size_t>(States::states_A2)][static_cast<std::size_t>(SymbolicTokenClass::LETTER)] = B1a;
-    table[static_cast<std::size_t>(States::states_A2)][static_cast<std::size_t>(SymbolicTokenClass::ARITHMETIC_OPERATION)] = C1a;
-    table[static_cast<std::size_t>(States::states_A2)][static_cast<std::size_t>(SymbolicTokenClass::COMPARISON_OPERATION)] = D1a;
-    table[static_cast<std::size_t>(States::states_A2)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = A2;
-    table[static_cast<std::size_t>(States::states_A2)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = A2a;
-    table[static_cast<std::size_t>(States::states_A2)][static_cast<std::size_t>(SymbolicTokenClass::SEMICOLON)] = I2a;
-    table[static_cast<std::size_t>(States::states_A2)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_FILE)] = EXIT1;
-
-    table[static_cast<std::size_t>(States::states_B1)][static_cast<std::size_t>(SymbolicTokenClass::LETTER)] = M1;
-    table[static_cast<std::size_t>(States::states_B1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = A2f;
-
-    table[static_cast<std::size_t>(States::states_C1)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = C1;
-    table[static_cast<std::size_t>(States::states_C1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = A2a;
-    table[static_cast<std::size_t>(States::states_C1)][static_cast<std::size_t>(SymbolicTokenClass::SEMICOLON)] = I2a;
-    table[static_cast<std::size_t>(States::states_C1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_FILE)] = EXIT1;
-
-    table[static_cast<std::size_t>(States::states_D1)][static_cast<std::size_t>(SymbolicTokenClass::COMPARISON_OPERATION)] = C1h;
-    table[static_cast<std::size_t>(States::states_D1)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = C1g;
-    table[static_cast<std::size_t>(States::states_D1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = A2e;
-    table[static_cast<std::size_t>(States::states_D1)][static_cast<std::size_t>(SymbolicTokenClass::SEMICOLON)] = I2d;
-    table[static_cast<std::size_t>(States::states_D1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_FILE)] = EXIT2;
-
-    table[static_cast<std::size_t>(States::states_E1)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = F1;
-    table[static_cast<std::size_t>(States::states_E1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = A2f;
-
-    table[static_cast<std::size_t>(States::states_E2)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = F2;
-    table[static_cast<std::size_t>(States::states_E2)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = A2f;
-
-    table[static_cast<std::size_t>(States::states_E3)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = F3;
-    table[static_cast<std::size_t>(States::states_E3)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = A2f;
-
-    table[static_cast<std::size_t>(States::states_F1)][static_cast<std::size_t>(SymbolicTokenClass::LETTER)] = H1a;
-    table[static_cast<std::size_t>(States::states_F1)][static_cast<std::size_t>(SymbolicTokenClass::DIGIT)] = G1a;
-    table[static_cast<std::size_t>(States::states_F1)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = F1;
-    table[static_cast<std::size_t>(States::states_F1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = A2f;
-    table[static_cast<std::size_t>(States::states_F1)][static_cast<std::size_t>(SymbolicTokenClass::VECTOR_SYMBOL)] = handleVectorStart;
-
-    table[static_cast<std::size_t>(States::states_F2)][static_cast<std::size_t>(SymbolicTokenClass::DIGIT)] = G1a;
-    table[static_cast<std::size_t>(States::states_F2)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = F2;
-    table[static_cast<std::size_t>(States::states_F2)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = A2f;
-
-    table[static_cast<std::size_t>(States::states_F3)][static_cast<std::size_t>(SymbolicTokenClass::LETTER)] = H1a;
-    table[static_cast<std::size_t>(States::states_F3)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = F3;
-    table[static_cast<std::size_t>(States::states_F3)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = A2f;
-
-    table[static_cast<std::size_t>(States::states_G1)][static_cast<std::size_t>(SymbolicTokenClass::DIGIT)] = G1b;
-    table[static_cast<std::size_t>(States::states_G1)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = C1e;
-    table[static_cast<std::size_t>(States::states_G1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = A2c;
-    table[static_cast<std::size_t>(States::states_G1)][static_cast<std::size_t>(SymbolicTokenClass::SEMICOLON)] = I2b;
-    table[static_cast<std::size_t>(States::states_G1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_FILE)] = EXIT3;
-
-    table[static_cast<std::size_t>(States::states_H1)][static_cast<std::size_t>(SymbolicTokenClass::LETTER)] = H1b;
-    table[static_cast<std::size_t>(States::states_H1)][static_cast<std::size_t>(SymbolicTokenClass::DIGIT)] = H1b;
-    table[static_cast<std::size_t>(States::states_H1)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = C1f;
-    table[static_cast<std::size_t>(States::states_H1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = A2d;
-    table[static_cast<std::size_t>(States::states_H1)][static_cast<std::size_t>(SymbolicTokenClass::SEMICOLON)] = I2c;
-    table[static_cast<std::size_t>(States::states_H1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_FILE)] = EXIT4;
-
-    table[static_cast<std::size_t>(States::states_I1)][static_cast<std::size_t>(SymbolicTokenClass::LETTER)] = I1;
-    table[static_cast<std::size_t>(States::states_I1)][static_cast<std::size_t>(SymbolicTokenClass::DIGIT)] = I1;
-    table[static_cast<std::size_t>(States::states_I1)][static_cast<std::size_t>(SymbolicTokenClass::ARITHMETIC_OPERATION)] = I1;
-    table[static_cast<std::size_t>(States::states_I1)][static_cast<std::size_t>(SymbolicTokenClass::COMPARISON_OPERATION)] = I1;
-    table[static_cast<std::size_t>(States::states_I1)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = I1;
-    table[static_cast<std::size_t>(States::states_I1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = A1a;
-    table[static_cast<std::size_t>(States::states_I1)][static_cast<std::size_t>(SymbolicTokenClass::SEMICOLON)] = I1;
-    table[static_cast<std::size_t>(States::states_I1)][static_cast<std::size_t>(SymbolicTokenClass::ERROR)] = I1;
-
-    table[static_cast<std::size_t>(States::states_I2)][static_cast<std::size_t>(SymbolicTokenClass::LETTER)] = I2;
-    table[static_cast<std::size_t>(States::states_I2)][static_cast<std::size_t>(SymbolicTokenClass::DIGIT)] = I2;
-    table[static_cast<std::size_t>(States::states_I2)][static_cast<std::size_t>(SymbolicTokenClass::ARITHMETIC_OPERATION)] = I2;
-    table[static_cast<std::size_t>(States::states_I2)][static_cast<std::size_t>(SymbolicTokenClass::COMPARISON_OPERATION)] = I2;
-    table[static_cast<std::size_t>(States::states_I2)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = I2;
-    table[static_cast<std::size_t>(States::states_I2)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = A2b;
-    table[static_cast<std::size_t>(States::states_I2)][static_cast<std::size_t>(SymbolicTokenClass::SEMICOLON)] = I2;
-    table[static_cast<std::size_t>(States::states_I2)][static_cast<std::size_t>(SymbolicTokenClass::ERROR)] = I2;
-    table[static_cast<std::size_t>(States::states_I2)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_FILE)] = EXIT1;
-
-    table[static_cast<std::size_t>(States::states_J1)][static_cast<std::size_t>(SymbolicTokenClass::LETTER)] = J1;
-    table[static_cast<std::size_t>(States::states_J1)][static_cast<std::size_t>(SymbolicTokenClass::DIGIT)] = J1;
-    table[static_cast<std::size_t>(States::states_J1)][static_cast<std::size_t>(SymbolicTokenClass::ARITHMETIC_OPERATION)] = J1;
-    table[static_cast<std::size_t>(States::states_J1)][static_cast<std::size_t>(SymbolicTokenClass::COMPARISON_OPERATION)] = J1;
-    table[static_cast<std::size_t>(States::states_J1)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = J1;
-    table[static_cast<std::size_t>(States::states_J1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = A2a;
-    table[static_cast<std::size_t>(States::states_J1)][static_cast<std::size_t>(SymbolicTokenClass::SEMICOLON)] = J1;
-    table[static_cast<std::size_t>(States::states_J1)][static_cast<std::size_t>(SymbolicTokenClass::ERROR)] = J1;
-    table[static_cast<std::size_t>(States::states_J1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_FILE)] = EXIT1;
-
-    table[static_cast<std::size_t>(States::states_V1)][static_cast<std::size_t>(SymbolicTokenClass::DIGIT)] = V1;
-    table[static_cast<std::size_t>(States::states_V2)][static_cast<std::size_t>(SymbolicTokenClass::COMMA)] = V2;
-    table[static_cast<std::size_t>(States::states_V1)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = V1;
-
-    table[static_cast<std::size_t>(States::states_V2)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = V2;
-    table[static_cast<std::size_t>(States::states_V2)][static_cast<std::size_t>(SymbolicTokenClass::DIGIT)] = V2;
-    table[static_cast<std::size_t>(States::states_V2)][static_cast<std::size_t>(SymbolicTokenClass::VECTOR_SYMBOL)] = V2;
+        std::ranges::fill(row, Transition::error);
+
+    table[static_cast<std::size_t>(States::states_A1)][static_cast<std::size_t>(SymbolicTokenClass::LETTER)] = Transition::B1a;
+    table[static_cast<std::size_t>(States::states_A1)][static_cast<std::size_t>(SymbolicTokenClass::ARITHMETIC_OPERATION)] = Transition::C1a;
+    table[static_cast<std::size_t>(States::states_A1)][static_cast<std::size_t>(SymbolicTokenClass::COMPARISON_OPERATION)] = Transition::D1a;
+    table[static_cast<std::size_t>(States::states_A1)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = Transition::A1;
+    table[static_cast<std::size_t>(States::states_A1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = Transition::A1b;
+    table[static_cast<std::size_t>(States::states_A1)][static_cast<std::size_t>(SymbolicTokenClass::SEMICOLON)] = Transition::I1a;
+
+    table[static_cast<std::size_t>(States::states_A2)][static_cast<std::size_t>(SymbolicTokenClass::LETTER)] = Transition::B1a;
+    table[static_cast<std::size_t>(States::states_A2)][static_cast<std::size_t>(SymbolicTokenClass::ARITHMETIC_OPERATION)] = Transition::C1a;
+    table[static_cast<std::size_t>(States::states_A2)][static_cast<std::size_t>(SymbolicTokenClass::COMPARISON_OPERATION)] = Transition::D1a;
+    table[static_cast<std::size_t>(States::states_A2)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = Transition::A2;
+    table[static_cast<std::size_t>(States::states_A2)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = Transition::A2a;
+    table[static_cast<std::size_t>(States::states_A2)][static_cast<std::size_t>(SymbolicTokenClass::SEMICOLON)] = Transition::I2a;
+    table[static_cast<std::size_t>(States::states_A2)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_FILE)] = Transition::EXIT1;
+
+    table[static_cast<std::size_t>(States::states_B1)][static_cast<std::size_t>(SymbolicTokenClass::LETTER)] = Transition::M1;
+    table[static_cast<std::size_t>(States::states_B1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = Transition::A2f;
+
+    table[static_cast<std::size_t>(States::states_C1)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = Transition::C1;
+    table[static_cast<std::size_t>(States::states_C1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = Transition::A2a;
+    table[static_cast<std::size_t>(States::states_C1)][static_cast<std::size_t>(SymbolicTokenClass::SEMICOLON)] = Transition::I2a;
+    table[static_cast<std::size_t>(States::states_C1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_FILE)] = Transition::EXIT1;
+
+    table[static_cast<std::size_t>(States::states_D1)][static_cast<std::size_t>(SymbolicTokenClass::COMPARISON_OPERATION)] = Transition::C1h;
+    table[static_cast<std::size_t>(States::states_D1)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = Transition::C1g;
+    table[static_cast<std::size_t>(States::states_D1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = Transition::A2e;
+    table[static_cast<std::size_t>(States::states_D1)][static_cast<std::size_t>(SymbolicTokenClass::SEMICOLON)] = Transition::I2d;
+    table[static_cast<std::size_t>(States::states_D1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_FILE)] = Transition::EXIT2;
+
+    table[static_cast<std::size_t>(States::states_E1)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = Transition::F1;
+    table[static_cast<std::size_t>(States::states_E1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = Transition::A2f;
+
+    table[static_cast<std::size_t>(States::states_E2)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = Transition::F2;
+    table[static_cast<std::size_t>(States::states_E2)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = Transition::A2f;
+
+    table[static_cast<std::size_t>(States::states_E3)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = Transition::F3;
+    table[static_cast<std::size_t>(States::states_E3)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = Transition::A2f;
+
+    table[static_cast<std::size_t>(States::states_F1)][static_cast<std::size_t>(SymbolicTokenClass::LETTER)] = Transition::H1a;
+    table[static_cast<std::size_t>(States::states_F1)][static_cast<std::size_t>(SymbolicTokenClass::DIGIT)] = Transition::G1a;
+    table[static_cast<std::size_t>(States::states_F1)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = Transition::F1;
+    table[static_cast<std::size_t>(States::states_F1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = Transition::A2f;
+    table[static_cast<std::size_t>(States::states_F1)][static_cast<std::size_t>(SymbolicTokenClass::VECTOR_SYMBOL)] = Transition::handleVectorStart;
+
+    table[static_cast<std::size_t>(States::states_F2)][static_cast<std::size_t>(SymbolicTokenClass::DIGIT)] = Transition::G1a;
+    table[static_cast<std::size_t>(States::states_F2)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = Transition::F2;
+    table[static_cast<std::size_t>(States::states_F2)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = Transition::A2f;
+
+    table[static_cast<std::size_t>(States::states_F3)][static_cast<std::size_t>(SymbolicTokenClass::LETTER)] = Transition::H1a;
+    table[static_cast<std::size_t>(States::states_F3)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = Transition::F3;
+    table[static_cast<std::size_t>(States::states_F3)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = Transition::A2f;
+
+    table[static_cast<std::size_t>(States::states_G1)][static_cast<std::size_t>(SymbolicTokenClass::DIGIT)] = Transition::G1b;
+    table[static_cast<std::size_t>(States::states_G1)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = Transition::C1e;
+    table[static_cast<std::size_t>(States::states_G1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = Transition::A2c;
+    table[static_cast<std::size_t>(States::states_G1)][static_cast<std::size_t>(SymbolicTokenClass::SEMICOLON)] = Transition::I2b;
+    table[static_cast<std::size_t>(States::states_G1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_FILE)] = Transition::EXIT3;
+
+    table[static_cast<std::size_t>(States::states_H1)][static_cast<std::size_t>(SymbolicTokenClass::LETTER)] = Transition::H1b;
+    table[static_cast<std::size_t>(States::states_H1)][static_cast<std::size_t>(SymbolicTokenClass::DIGIT)] = Transition::H1b;
+    table[static_cast<std::size_t>(States::states_H1)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = Transition::C1f;
+    table[static_cast<std::size_t>(States::states_H1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = Transition::A2d;
+    table[static_cast<std::size_t>(States::states_H1)][static_cast<std::size_t>(SymbolicTokenClass::SEMICOLON)] = Transition::I2c;
+    table[static_cast<std::size_t>(States::states_H1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_FILE)] = Transition::EXIT4;
+
+    table[static_cast<std::size_t>(States::states_I1)][static_cast<std::size_t>(SymbolicTokenClass::LETTER)] = Transition::I1;
+    table[static_cast<std::size_t>(States::states_I1)][static_cast<std::size_t>(SymbolicTokenClass::DIGIT)] = Transition::I1;
+    table[static_cast<std::size_t>(States::states_I1)][static_cast<std::size_t>(SymbolicTokenClass::ARITHMETIC_OPERATION)] = Transition::I1;
+    table[static_cast<std::size_t>(States::states_I1)][static_cast<std::size_t>(SymbolicTokenClass::COMPARISON_OPERATION)] = Transition::I1;
+    table[static_cast<std::size_t>(States::states_I1)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = Transition::I1;
+    table[static_cast<std::size_t>(States::states_I1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = Transition::A1a;
+    table[static_cast<std::size_t>(States::states_I1)][static_cast<std::size_t>(SymbolicTokenClass::SEMICOLON)] = Transition::I1;
+    table[static_cast<std::size_t>(States::states_I1)][static_cast<std::size_t>(SymbolicTokenClass::ERROR)] = Transition::I1;
+
+    table[static_cast<std::size_t>(States::states_I2)][static_cast<std::size_t>(SymbolicTokenClass::LETTER)] = Transition::I2;
+    table[static_cast<std::size_t>(States::states_I2)][static_cast<std::size_t>(SymbolicTokenClass::DIGIT)] = Transition::I2;
+    table[static_cast<std::size_t>(States::states_I2)][static_cast<std::size_t>(SymbolicTokenClass::ARITHMETIC_OPERATION)] = Transition::I2;
+    table[static_cast<std::size_t>(States::states_I2)][static_cast<std::size_t>(SymbolicTokenClass::COMPARISON_OPERATION)] = Transition::I2;
+    table[static_cast<std::size_t>(States::states_I2)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = Transition::I2;
+    table[static_cast<std::size_t>(States::states_I2)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = Transition::A2b;
+    table[static_cast<std::size_t>(States::states_I2)][static_cast<std::size_t>(SymbolicTokenClass::SEMICOLON)] = Transition::I2;
+    table[static_cast<std::size_t>(States::states_I2)][static_cast<std::size_t>(SymbolicTokenClass::ERROR)] = Transition::I2;
+    table[static_cast<std::size_t>(States::states_I2)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_FILE)] = Transition::EXIT1;
+
+    table[static_cast<std::size_t>(States::states_J1)][static_cast<std::size_t>(SymbolicTokenClass::LETTER)] = Transition::J1;
+    table[static_cast<std::size_t>(States::states_J1)][static_cast<std::size_t>(SymbolicTokenClass::DIGIT)] = Transition::J1;
+    table[static_cast<std::size_t>(States::states_J1)][static_cast<std::size_t>(SymbolicTokenClass::ARITHMETIC_OPERATION)] = Transition::J1;
+    table[static_cast<std::size_t>(States::states_J1)][static_cast<std::size_t>(SymbolicTokenClass::COMPARISON_OPERATION)] = Transition::J1;
+    table[static_cast<std::size_t>(States::states_J1)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = Transition::J1;
+    table[static_cast<std::size_t>(States::states_J1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_LINE)] = Transition::A2a;
+    table[static_cast<std::size_t>(States::states_J1)][static_cast<std::size_t>(SymbolicTokenClass::SEMICOLON)] = Transition::J1;
+    table[static_cast<std::size_t>(States::states_J1)][static_cast<std::size_t>(SymbolicTokenClass::ERROR)] = Transition::J1;
+    table[static_cast<std::size_t>(States::states_J1)][static_cast<std::size_t>(SymbolicTokenClass::END_OF_FILE)] = Transition::EXIT1;
+
+    table[static_cast<std::size_t>(States::states_V1)][static_cast<std::size_t>(SymbolicTokenClass::DIGIT)] = Transition::V1;
+    table[static_cast<std::size_t>(States::states_V2)][static_cast<std::size_t>(SymbolicTokenClass::COMMA)] = Transition::V2;
+    table[static_cast<std::size_t>(States::states_V1)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = Transition::V1;
+
+    table[static_cast<std::size_t>(States::states_V2)][static_cast<std::size_t>(SymbolicTokenClass::SPACE_OR_TAB)] = Transition::V2;
+    table[static_cast<std::size_t>(States::states_V2)][static_cast<std::size_t>(SymbolicTokenClass::DIGIT)] = Transition::V2;
+    table[static_cast<std::size_t>(States::states_V2)][static_cast<std::size_t>(SymbolicTokenClass::VECTOR_SYMBOL)] = Transition::V2;
 
     return table;
 }
 
-void parse(const std::string &filePath) {
-    const TransitionTable table = initializeTable();
+void Lexer::reset() {
+    result = LexResult{};
+    currentVector.clear();
+    pending.clear();
+    streaming = false;
 
-    file.open(filePath);
-    if (!file) {
-        std::cerr << "Не удалось открыть файл: " << filePath << std::endl;
-        return;
+    numberRegister = 0;
+    classRegister = 0;
+    relationRegister = '\0';
+    variableRegister.clear();
+    identifierStart = nullptr;
+    lineNumber = 1;
+    constantFlag = false;
+    detectionRegister = 0;
+    pointerRegister = 0;
+    inComment = false;
+    globalSymbol = SymbolicToken{};
+}
+
+// Вызов обработчика по номеру перехода. Обработчики вызываются напрямую, поэтому компилятор
+// может встроить их в цикл разбора вместо косвенного вызова на каждый символ
+States Lexer::dispatch(Transition transition) {
+    switch (transition) {
+        case Transition::error:
+            return errorTransition();
+        case Transition::A1:
+            return A1();
+        case Transition::A1a:
+            return A1a();
+        case Transition::A1b:
+            return A1b();
+        case Transition::A2:
+            return A2();
+        case Transition::A2a:
+            return A2a();
+        case Transition::A2b:
+            return A2b();
+        case Transition::A2c:
+            return A2c();
+        case Transition::A2d:
+            return A2d();
+        case Transition::A2e:
+            return A2e();
+        case Transition::A2f:
+            return A2f();
+        case Transition::B1a:
+            return B1a();
+        case Transition::C1:
+            return C1();
+        case Transition::C1a:
+            return C1a();
+        case Transition::C1e:
+            return C1e();
+        case Transition::C1f:
+            return C1f();
+        case Transition::C1g:
+            return C1g();
+        case Transition::C1h:
+            return C1h();
+        case Transition::D1a:
+            return D1a();
+        case Transition::EXIT1:
+            return EXIT1();
+        case Transition::EXIT2:
+            return EXIT2();
+        case Transition::EXIT3:
+            return EXIT3();
+        case Transition::EXIT4:
+            return EXIT4();
+        case Transition::F1:
+            return F1();
+        case Transition::F2:
+            return F2();
+        case Transition::F3:
+            return F3();
+        case Transition::G1a:
+            return G1a();
+        case Transition::G1b:
+            return G1b();
+        case Transition::H1a:
+            return H1a();
+        case Transition::H1b:
+            return H1b();
+        case Transition::I1:
+            return I1();
+        case Transition::I1a:
+            return I1a();
+        case Transition::I2:
+            return I2();
+        case Transition::I2a:
+            return I2a();
+        case Transition::I2b:
+            return I2b();
+        case Transition::I2c:
+            return I2c();
+        case Transition::I2d:
+            return I2d();
+        case Transition::J1:
+            return J1();
+        case Transition::M1:
+            return M1();
+        case Transition::V1:
+            return V1();
+        case Transition::V2:
+            return V2();
+        case Transition::handleVectorStart:
+            return handleVectorStart();
     }
 
-    auto currentState = States::states_A1;
+    return errorTransition();
+}
 
-    while (currentState != States::states_STOP) {
-        const int charCode = file.get();
+LexResult Lexer::parse(std::string_view source) {
+    return parseRange(source, States::states_A1, 1, true);
+}
 
-        if (charCode == EOF) {
-            globalSymbol = transliterator(EOF);
-            auto tokenClass = static_cast<size_t>(globalSymbol.tokenClass);
-            auto stateIndex = static_cast<size_t>(currentState);
+LexResult Lexer::parseRange(std::string_view source, States startState, unsigned firstLine, bool lastChunk) {
+    reset();
+    lineNumber = firstLine;
+    sourceCursor = source.data();
+    sourceEnd = source.data() + source.size();
 
-            if (stateIndex >= table.size() || tokenClass >= table[stateIndex].size()) {
-                std::cerr << "Ошибка: неверные индексы доступа к таблице переходов." << std::endl;
-                break;
-            }
+    auto currentState = startState;
+    while (step(currentState, lastChunk)) {}
 
-            if (const functionPointer nextStateFunction = table[stateIndex][tokenClass])
-                currentState = nextStateFunction();
-            else
-                std::cerr << "Ошибка: отсутствует функция перехода для EOF." << std::endl;
-            break;
-        }
+    sourceCursor = nullptr;
+    sourceEnd = nullptr;
+
+    return std::move(result);
+}
 
-        char currentChar = static_cast<char>(charCode);
-        globalSymbol = transliterator(currentChar);
+bool Lexer::step(States &currentState, bool processEnd) {
+    static constexpr TransitionTable table = initializeTable();
 
-        const auto tokenClass = static_cast<size_t>(globalSymbol.tokenClass);
-        const auto stateIndex = static_cast<size_t>(currentState);
+    if (currentState == States::states_STOP)
+        return false;
+
+    if (sourceCursor == sourceEnd) {
+        // Конец файла обрабатывается только в последней части текста
+        if (!processEnd)
+            return false;
+
+        globalSymbol = transliterator(EOF);
+        auto tokenClass = static_cast<size_t>(globalSymbol.tokenClass);
+        auto stateIndex = static_cast<size_t>(currentState);
 
         if (stateIndex >= table.size() || tokenClass >= table[stateIndex].size()) {
-            std::cerr << "Ошибка: неверные индексы доступа к таблице переходов." << std::endl;
-            break;
+            report(lineNumber, "неверные индексы доступа к таблице переходов");
+            return false;
+        }
+
+        currentState = dispatch(table[stateIndex][tokenClass]);
+        return false;
+    }
+
+    const auto currentChar = static_cast<unsigned char>(*sourceCursor);
+
+    // Тело комментария и серии пробелов не меняют состояние автомата, поэтому пропускаются разом
+    if (inComment && currentChar != '\n' && skipsComment(currentState)) {
+        const void *newline = std::memchr(sourceCursor, '\n', static_cast<std::size_t>(sourceEnd - sourceCursor));
+        sourceCursor = newline ? static_cast<const char *>(newline) : sourceEnd;
+        return true;
+    }
+
+    if ((currentChar == ' ' || currentChar == '\t') && absorbsBlanks(currentState)) {
+        while (sourceCursor != sourceEnd && (*sourceCursor == ' ' || *sourceCursor == '\t'))
+            ++sourceCursor;
+        return true;
+    }
+
+    ++sourceCursor;
+    globalSymbol = transliterator(currentChar);
+
+    const auto tokenClass = static_cast<size_t>(globalSymbol.tokenClass);
+    const auto stateIndex = static_cast<size_t>(currentState);
+
+    if (stateIndex >= table.size() || tokenClass >= table[stateIndex].size()) {
+        report(lineNumber, "неверные индексы доступа к таблице переходов");
+        return false;
+    }
+
+    currentState = dispatch(table[stateIndex][tokenClass]);
+
+    return true;
+}
+
+void Lexer::start(std::string_view source) {
+    reset();
+    streaming = true;
+    streamState = States::states_A1;
+    sourceCursor = source.data();
+    sourceEnd = source.data() + source.size();
+}
+
+bool Lexer::next(Lexeme &lexeme) {
+    // Автомат продвигается, только пока не появится очередная лексема
+    while (pending.empty() && streaming)
+        if (!step(streamState, true)) {
+            // Последний шаг мог добавить лексемы, они выдаются следующими вызовами
+            streaming = false;
+            sourceCursor = nullptr;
+            sourceEnd = nullptr;
         }
 
-        if (const functionPointer nextStateFunction = table[stateIndex][tokenClass])
-            currentState = nextStateFunction();
-        else
+    if (pending.empty())
+        return false;
+
+    lexeme = pending.front();
+    pending.pop_front();
+
+    return true;
+}
+
+bool Lexer::onlyBlankLines(std::string_view text) {
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        const char ch = text[i];
+        if (ch == ' ' || ch == '\t' || ch == '\n')
+            continue;
+
+        if (ch != ';')
+            return false;
+
+        i = text.find('\n', i);
+        if (i == std::string_view::npos)
             break;
     }
 
-    file.close();
+    return true;
+}
+
+LexResult Lexer::parseParallel(std::string_view source, unsigned threadCount) {
+    if (threadCount == 0)
+        threadCount = std::clamp(std::thread::hardware_concurrency(), 1U, maxLexThreads);
+
+    if (source.size() < parallelThreshold || threadCount == 1)
+        return Lexer{}.parse(source);
+
+    // Текст делится на части по границам строк: язык построчный, поэтому каждая часть
+    // разбирается независимо, начиная с состояния, в котором её застал бы последовательный разбор
+    struct Chunk {
+        std::string_view text;
+        States startState;
+        unsigned firstLine;
+    };
+
+    std::vector<Chunk> chunks;
+    const std::size_t part = source.size() / threadCount;
+    std::size_t begin = 0;
+    unsigned line = 1;
+    bool blankPrefix = true; // до начала части были только пустые строки и комментарии
+
+    while (begin < source.size()) {
+        std::size_t end = source.size();
+        if (chunks.size() + 1 < threadCount) {
+            const std::size_t newline = source.find('\n', begin + part);
+            if (newline != std::string_view::npos)
+                end = newline + 1;
+        }
+
+        const std::string_view text = source.substr(begin, end - begin);
+        chunks.push_back({text, blankPrefix ? States::states_A1 : States::states_A2, line});
+
+        line += static_cast<unsigned>(std::ranges::count(text, '\n'));
+        blankPrefix = blankPrefix && onlyBlankLines(text);
+        begin = end;
+    }
+
+    std::vector<LexResult> parts(chunks.size());
+    std::vector<std::exception_ptr> errors(chunks.size());
+    std::vector<std::thread> workers;
+    workers.reserve(chunks.size());
+
+    for (std::size_t i = 0; i < chunks.size(); ++i)
+        workers.emplace_back([&, i] {
+            try {
+                parts[i] = Lexer{}.parseRange(chunks[i].text, chunks[i].startState, chunks[i].firstLine,
+                                              i + 1 == chunks.size());
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+
+    for (std::thread &worker: workers)
+        worker.join();
+
+    for (const std::exception_ptr &error: errors)
+        if (error)
+            std::rethrow_exception(error);
+
+    // Слияние: имена нумеруются в порядке первого появления, как при последовательном разборе
+    LexResult merged = std::move(parts.front());
+    for (std::size_t i = 1; i < parts.size(); ++i) {
+        LexResult &chunk = parts[i];
+
+        std::vector<unsigned> renumber(chunk.nameTable.size());
+        for (unsigned id = 0; id < renumber.size(); ++id) {
+            // Имена, взятые прямо из текста, остаются ссылками на него; копии из таблицы части копируются снова
+            const std::string_view name = chunk.nameTable.name(id);
+            const bool borrowed = !std::less<>{}(name.data(), source.data()) &&
+                                  std::less<>{}(name.data(), source.data() + source.size());
+            renumber[id] = merged.nameTable.intern(name, borrowed);
+        }
+
+        std::vector<unsigned> constantIndex(chunk.constantTable.size());
+        for (unsigned index = 0; index < constantIndex.size(); ++index)
+            constantIndex[index] = merged.constantTable.intern(chunk.constantTable.value(index));
+
+        // Векторы части дописываются в конец общей таблицы, их номера сдвигаются.
+        // Строки не делятся между частями, поэтому push и его константа лежат в одной части
+        const auto vectorOffset = static_cast<unsigned>(merged.vectors.size());
+        merged.lexemes.reserve(merged.lexemes.size() + chunk.lexemes.size());
+        LexemeClass previousClass{};
+        for (Lexeme lexeme: chunk.lexemes) {
+            if (lexeme.lexemeClass == LexemeClass::VARIABLE)
+                lexeme.value = renumber[lexeme.value];
+            else if (lexeme.lexemeClass == LexemeClass::VECTOR)
+                lexeme.value += vectorOffset;
+            else if (isPooledConstant(previousClass, lexeme.lexemeClass))
+                lexeme.value = constantIndex[lexeme.value];
+            previousClass = lexeme.lexemeClass;
+            merged.lexemes.push_back(lexeme);
+        }
+
+        merged.vectors.insert(merged.vectors.end(), std::make_move_iterator(chunk.vectors.begin()),
+                              std::make_move_iterator(chunk.vectors.end()));
+        merged.diagnostics.insert(merged.diagnostics.end(), std::make_move_iterator(chunk.diagnostics.begin()),
+                                  std::make_move_iterator(chunk.diagnostics.end()));
+    }
+
+    return merged;
+}
+
+LexResult parse(const std::string &filePath, const std::string &cacheDirectory) {
+    SourceBuffer source;
+    try {
+        source = SourceBuffer::map(filePath);
+    } catch (const std::runtime_error &) {
+        LexResult result;
+        result.diagnostics.push_back({0, "Не удалось открыть файл: " + filePath});
+        return result;
+    }
+
+    auto buffer = std::make_shared<const SourceBuffer>(std::move(source));
+    if (cacheDirectory.empty()) {
+        LexResult result = Lexer::parseParallel(buffer->view());
+        result.source = std::move(buffer);
+
+        return result;
+    }
+
+    // Неизменённая программа берётся из кэша без разбора
+    const std::uint64_t sourceHash = TokenCache::hashSource(buffer->view());
+    const std::string cachePath = TokenCache::path(cacheDirectory, sourceHash);
+    if (std::optional<LexResult> cached = TokenCache::load(cachePath, buffer->view(), sourceHash))
+        return std::move(*cached);
+
+    // Сообщения в файл не записываются, поэтому программа с ошибками не кэшируется:
+    // каждый запуск разбирает её заново и выдаёт те же сообщения
+    LexResult result = Lexer::parseParallel(buffer->view());
+    if (result.diagnostics.empty()) {
+        try {
+            TokenCache::save(cachePath, buffer->view(), sourceHash, result);
+        } catch (const std::runtime_error &e) {
+            result.diagnostics.push_back({0, e.what()});
+        }
+    }
+    result.source = std::move(buffer);
+
+    return result;
 }
@@ -0,0 +1,254 @@
+#include <functional>
+#include <optional>
+
+#include "../include/Optimizer.hpp"
+
+namespace {
+    bool isConditionalJump(Opcode opcode) {
+        return opcode == Opcode::JI || (opcode >= Opcode::JLESS && opcode <= Opcode::JNOT_EQUAL);
+    }
+
+    bool isJump(Opcode opcode) {
+        return opcode == Opcode::JMP || isConditionalJump(opcode);
+    }
+
+    // Условный переход, в который сливается отношение со следующим за ним ji
+    std::optional<Opcode> branchFor(Opcode comparison) {
+        switch (comparison) {
+            case Opcode::LESS: return Opcode::JLESS;
+            case Opcode::GREATER: return Opcode::JGREATER;
+            case Opcode::LESS_EQUAL: return Opcode::JLESS_EQUAL;
+            case Opcode::GREATER_EQUAL: return Opcode::JGREATER_EQUAL;
+            case Opcode::EQUAL: return Opcode::JEQUAL;
+            case Opcode::NOT_EQUAL: return Opcode::JNOT_EQUAL;
+            default: return std::nullopt;
+        }
+    }
+
+    // Результат операции над числами; nullopt, если это не операция над числами.
+    // Ошибки (деление на ноль, отрицательная разность) бросаются так же, как при выполнении
+    std::optional<BigNat> evaluate(Opcode opcode, const BigNat &a, const BigNat &b) {
+        auto relation = [](bool holds) { return BigNat(holds ? 1U : 0U); };
+
+        switch (opcode) {
+            case Opcode::ADD: return a + b;
+            case Opcode::SUB: return a - b;
+            case Opcode::MUL: return a * b;
+            case Opcode::DIV: return a / b;
+            case Opcode::MOD: return a % b;
+            case Opcode::LESS: return relation(a < b);
+            case Opcode::GREATER: return relation(a > b);
+            case Opcode::LESS_EQUAL: return relation(a <= b);
+            case Opcode::GREATER_EQUAL: return relation(a >= b);
+            case Opcode::EQUAL: return relation(a == b);
+            case Opcode::NOT_EQUAL: return relation(a != b);
+            default: return std::nullopt;
+        }
+    }
+}
+
+Optimizer::Optimizer(Bytecode &bytecode, std::vector<Value> &constants, ValueHeap &heap)
+    : bytecode(bytecode), constants(constants), heap(heap) {}
+
+void Optimizer::optimize() {
+    bool changed = true;
+    while (changed) {
+        changed = rewrite();
+        changed = removeUnreachable() || changed;
+    }
+}
+
+bool Optimizer::window(std::size_t first, std::size_t count) const {
+    if (first + count > bytecode.code.size())
+        return false;
+
+    for (std::size_t i = first + 1; i < first + count; ++i)
+        if (removed[i] || targets[i])
+            return false;
+
+    return true;
+}
+
+BigNat Optimizer::number(std::uint32_t constant) {
+    // take отдаёт объект вместе со ссылкой, поэтому таблице констант сначала добавляется ещё одна
+    heap.retain(constants[constant]);
+    return heap.take<BigNat>(constants[constant]);
+}
+
+bool Optimizer::foldConstant(std::size_t i) {
+    const std::vector<Instruction> &code = bytecode.code;
+    if (!window(i, 3) || code[i].opcode != Opcode::PUSH_CONSTANT || code[i + 1].opcode != Opcode::PUSH_CONSTANT)
+        return false;
+
+    std::optional<BigNat> result;
+    try {
+        result = evaluate(code[i + 2].opcode, number(code[i].operand), number(code[i + 1].operand));
+    } catch (const std::exception &) {
+        return false; // ошибка будет сообщена при выполнении, на своей строке
+    }
+    if (!result)
+        return false;
+
+    constants.push_back(heap.make(std::move(*result)));
+    bytecode.code[i].operand = static_cast<std::uint32_t>(constants.size() - 1);
+    removed[i + 1] = removed[i + 2] = true;
+
+    return true;
+}
+
+bool Optimizer::foldBranch(std::size_t i) {
+    std::vector<Instruction> &code = bytecode.code;
+    if (!window(i, 2) || code[i].opcode != Opcode::PUSH_CONSTANT || code[i + 1].opcode != Opcode::JI)
+        return false;
+
+    if (number(code[i].operand).isZero())
+        removed[i] = true;
+    else
+        code[i] = {Opcode::JMP, code[i + 1].operand};
+    removed[i + 1] = true;
+
+    return true;
+}
+
+bool Optimizer::fuseIncrement(std::size_t i) {
+    std::vector<Instruction> &code = bytecode.code;
+    if (!window(i, 4) || code[i].opcode != Opcode::PUSH_VARIABLE || code[i + 1].opcode != Opcode::PUSH_CONSTANT ||
+        (code[i + 2].opcode != Opcode::ADD && code[i + 2].opcode != Opcode::SUB) ||
+        code[i + 3].opcode != Opcode::POP || code[i + 3].operand != code[i].operand)
+        return false;
+
+    const Value step = constants[code[i + 1].operand];
+    if (!step.isInline() || step.inlineNumber() != 1)
+        return false;
+
+    // Ошибку (не число или отрицательная разность) сообщает операция
+    code[i].opcode = code[i + 2].opcode == Opcode::ADD ? Opcode::INC : Opcode::DEC;
+    bytecode.lines[i] = bytecode.lines[i + 2];
+    removed[i + 1] = removed[i + 2] = removed[i + 3] = true;
+
+    return true;
+}
+
+bool Optimizer::fuseBranch(std::size_t i) {
+    std::vector<Instruction> &code = bytecode.code;
+    if (!window(i, 2) || code[i + 1].opcode != Opcode::JI)
+        return false;
+
+    const std::optional<Opcode> branch = branchFor(code[i].opcode);
+    if (!branch)
+        return false;
+
+    // Результат отношения — всегда число, поэтому ji ошибки сообщить не может и строка остаётся от отношения
+    code[i] = {*branch, code[i + 1].operand};
+    removed[i + 1] = true;
+
+    return true;
+}
+
+bool Optimizer::fuseStore(std::size_t i) {
+    std::vector<Instruction> &code = bytecode.code;
+    if (!window(i, 2) || (code[i].opcode != Opcode::VSET && code[i].opcode != Opcode::VSCATTER) ||
+        code[i + 1].opcode != Opcode::POP)
+        return false;
+
+    // После vset и vscatter в стеке есть результат, поэтому pop ошибки не сообщит
+    const Opcode fused = code[i].opcode == Opcode::VSET ? Opcode::VSET_VARIABLE : Opcode::VSCATTER_VARIABLE;
+    code[i] = {fused, code[i + 1].operand};
+    removed[i + 1] = true;
+
+    return true;
+}
+
+bool Optimizer::removeJumpToNext(std::size_t i) {
+    if (bytecode.code[i].opcode != Opcode::JMP || bytecode.code[i].operand != i + 1)
+        return false;
+
+    removed[i] = true;
+
+    return true;
+}
+
+bool Optimizer::rewrite() {
+    const std::vector<Instruction> &code = bytecode.code;
+    targets.assign(code.size(), false);
+    for (const Instruction &instruction: code)
+        if (isJump(instruction.opcode))
+            targets[instruction.operand] = true;
+
+    removed.assign(code.size(), false);
+    bool changed = false;
+    for (std::size_t i = 0; i < code.size(); ++i) {
+        if (removed[i])
+            continue;
+
+        if (foldConstant(i) || foldBranch(i) || fuseIncrement(i) || fuseBranch(i) || fuseStore(i) ||
+            removeJumpToNext(i))
+            changed = true;
+    }
+
+    if (changed)
+        compact();
+
+    return changed;
+}
+
+bool Optimizer::removeUnreachable() {
+    const std::vector<Instruction> &code = bytecode.code;
+    std::vector<bool> reachable(code.size(), false);
+    std::vector<std::size_t> pending{0};
+
+    while (!pending.empty()) {
+        const std::size_t i = pending.back();
+        pending.pop_back();
+        if (reachable[i])
+            continue;
+
+        reachable[i] = true;
+        const Opcode opcode = code[i].opcode;
+        if (isJump(opcode))
+            pending.push_back(code[i].operand);
+        if (opcode != Opcode::JMP && opcode != Opcode::END && opcode != Opcode::FAIL)
+            pending.push_back(i + 1);
+    }
+
+    // Последняя инструкция END остаётся всегда: на неё ведут переходы за пределы программы
+    reachable.back() = true;
+
+    removed.assign(code.size(), false);
+    bool changed = false;
+    for (std::size_t i = 0; i < code.size(); ++i)
+        if (!reachable[i])
+            removed[i] = changed = true;
+
+    if (changed)
+        compact();
+
+    return changed;
+}
+
+void Optimizer::compact() {
+    // Переход на удалённую инструкцию ведёт на первую оставшуюся после неё
+    std::vector<std::uint32_t> newIndex(bytecode.code.size());
+    std::uint32_t next = 0;
+    for (std::size_t i = 0; i < bytecode.code.size(); ++i) {
+        newIndex[i] = next;
+        if (!removed[i])
+            ++next;
+    }
+
+    Bytecode compacted;
+    compacted.code.reserve(next);
+    compacted.lines.reserve(next);
+    for (std::size_t i = 0; i < bytecode.code.size(); ++i) {
+        if (removed[i])
+            continue;
+
+        Instruction instruction = bytecode.code[i];
+        if (isJump(instruction.opcode))
+            instruction.operand = newIndex[instruction.operand];
+        compacted.code.push_back(instruction);
+        compacted.lines.push_back(bytecode.lines[i]);
+    }
+
+    bytecode = std::move(compacted);
+}
@@ -0,0 +1,73 @@
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../include/SourceBuffer.hpp"
+
+SourceBuffer::SourceBuffer() : mapping(nullptr), mappingSize(0) {}
+
+SourceBuffer::SourceBuffer(std::string text) : owned(std::move(text)), mapping(nullptr), mappingSize(0) {}
+
+SourceBuffer::SourceBuffer(SourceBuffer &&other) noexcept
+    : owned(std::move(other.owned)), mapping(std::exchange(other.mapping, nullptr)),
+      mappingSize(std::exchange(other.mappingSize, 0)) {}
+
+SourceBuffer &SourceBuffer::operator=(SourceBuffer &&other) noexcept {
+    if (this != &other) {
+        if (mapping)
+            munmap(mapping, mappingSize);
+
+        owned = std::move(other.owned);
+        mapping = std::exchange(other.mapping, nullptr);
+        mappingSize = std::exchange(other.mappingSize, 0);
+    }
+
+    return *this;
+}
+
+SourceBuffer::~SourceBuffer() {
+    if (mapping)
+        munmap(mapping, mappingSize);
+}
+
+SourceBuffer SourceBuffer::map(const std::string &filePath) {
+    const int descriptor = open(filePath.c_str(), O_RDONLY);
+    if (descriptor < 0)
+        throw std::runtime_error("Не удалось открыть файл: " + filePath);
+
+    struct stat status{};
+    if (fstat(descriptor, &status) != 0) {
+        close(descriptor);
+        throw std::runtime_error("Не удалось получить размер файла: " + filePath);
+    }
+
+    SourceBuffer buffer;
+    // Пустой файл отобразить нельзя, он представляется пустой строкой
+    if (status.st_size > 0) {
+        const auto size = static_cast<std::size_t>(status.st_size);
+        void *address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (address == MAP_FAILED) {
+            close(descriptor);
+            throw std::runtime_error("Не удалось отобразить файл в память: " + filePath);
+        }
+
+        madvise(address, size, MADV_SEQUENTIAL);
+        buffer.mapping = address;
+        buffer.mappingSize = size;
+    }
+
+    close(descriptor);
+
+    return buffer;
+}
+
+std::string_view SourceBuffer::view() const {
+    if (mapping)
+        return {static_cast<const char *>(mapping), mappingSize};
+
+    return owned;
+}
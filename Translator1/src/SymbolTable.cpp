@@ -0,0 +1,7 @@
+#include "../include/SymbolTable.hpp"
+
+unsigned SymbolTable::intern(std::string_view name, bool borrowed) {
+    return names.intern(name, [this, borrowed](std::string_view added) {
+        return borrowed ? added : std::string_view(ownedNames.emplace_back(added));
+    });
+}
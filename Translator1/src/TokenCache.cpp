@@ -0,0 +1,321 @@
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <unistd.h>
+
+#include "../include/TokenCache.hpp"
+
+namespace {
+    constexpr std::array<char, 8> magic = {'R', 'G', 'R', '4', 'T', 'O', 'K', '\0'};
+    constexpr std::uint32_t byteOrderMark = 0x01020304; // файл с другим порядком байтов не подходит
+
+    struct Header {
+        std::array<char, 8> magic;
+        std::uint32_t version;
+        std::uint32_t byteOrder;
+        std::uint64_t sourceHash;
+        std::uint64_t sourceSize;
+        std::uint64_t lexemeCount;
+        std::uint64_t farLineCount;
+        std::uint64_t lastLine;
+        std::uint64_t constantCount;
+        std::uint64_t nameCount;
+        std::uint64_t nameBytes;
+        std::uint64_t vectorCount;
+        std::uint64_t vectorElements;
+    };
+
+    struct FarLine {
+        std::uint64_t index;
+        std::uint64_t line;
+    };
+
+    // Разделы идут за заголовком в этом порядке, каждый выровнен на 8 байт
+    struct Layout {
+        std::size_t classes = 0;
+        std::size_t values = 0;
+        std::size_t lineDeltas = 0;
+        std::size_t farLines = 0;
+        std::size_t constants = 0;
+        std::size_t nameOffsets = 0;
+        std::size_t names = 0;
+        std::size_t vectorOffsets = 0;
+        std::size_t vectorElements = 0;
+    };
+
+    static_assert(sizeof(unsigned) == sizeof(std::uint32_t), "значения лексем и элементы векторов записываются как uint32");
+
+    constexpr std::size_t align(std::size_t offset) {
+        return (offset + 7) & ~std::size_t{7};
+    }
+
+    // Размещает раздел из count элементов; false, если он не помещается в limit байт
+    bool place(std::size_t &offset, std::size_t &section, std::uint64_t count, std::size_t elementSize,
+               std::size_t limit) {
+        section = align(offset);
+        if (section > limit || count > (limit - section) / elementSize)
+            return false;
+
+        offset = section + static_cast<std::size_t>(count) * elementSize;
+
+        return true;
+    }
+
+    bool computeLayout(const Header &header, std::size_t limit, Layout &layout) {
+        std::size_t offset = sizeof(Header);
+
+        return place(offset, layout.classes, header.lexemeCount, sizeof(std::uint16_t), limit) &&
+               place(offset, layout.values, header.lexemeCount, sizeof(std::uint32_t), limit) &&
+               place(offset, layout.lineDeltas, header.lexemeCount, sizeof(std::uint8_t), limit) &&
+               place(offset, layout.farLines, header.farLineCount, sizeof(FarLine), limit) &&
+               place(offset, layout.constants, header.constantCount, sizeof(std::uint32_t), limit) &&
+               place(offset, layout.nameOffsets, header.nameCount + 1, sizeof(std::uint64_t), limit) &&
+               place(offset, layout.names, header.nameBytes, 1, limit) &&
+               place(offset, layout.vectorOffsets, header.vectorCount + 1, sizeof(std::uint64_t), limit) &&
+               place(offset, layout.vectorElements, header.vectorElements, sizeof(std::uint32_t), limit);
+    }
+
+    class Writer {
+        std::ofstream &file;
+        std::size_t written = 0;
+
+    public:
+        explicit Writer(std::ofstream &file) : file(file) {}
+
+        void bytes(const void *data, std::size_t size) {
+            file.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+            written += size;
+        }
+
+        void section(std::size_t offset) {
+            static constexpr std::array<char, 8> padding{};
+            bytes(padding.data(), offset - written);
+        }
+
+        template<typename T>
+        void items(const T *data, std::size_t count) {
+            bytes(data, count * sizeof(T));
+        }
+    };
+
+    template<typename T>
+    const T *at(const char *base, std::size_t offset) {
+        return reinterpret_cast<const T *>(base + offset);
+    }
+
+    // TokenStream берёт номер строки из farLines[farIndex++] на каждом байте farDelta, поэтому такие байты
+    // должны стоять ровно на индексах farLines, по одному на запись. Номера имён, векторов и констант
+    // в значениях лексем должны попадать в таблицы файла
+    bool validLexemes(const Header &header, const char *base, const Layout &layout) {
+        const auto lexemeCount = static_cast<std::size_t>(header.lexemeCount);
+        const auto *classes = at<std::uint16_t>(base, layout.classes);
+        const auto *values = at<std::uint32_t>(base, layout.values);
+        const auto *lineDeltas = at<std::uint8_t>(base, layout.lineDeltas);
+        const FarLine *farLines = at<FarLine>(base, layout.farLines);
+
+        std::size_t farIndex = 0;
+        LexemeClass previousClass{};
+        for (std::size_t i = 0; i < lexemeCount; ++i) {
+            if (lineDeltas[i] == TokenStream::farDelta) {
+                if (farIndex == header.farLineCount || farLines[farIndex].index != i)
+                    return false;
+                ++farIndex;
+            }
+
+            const auto lexemeClass = static_cast<LexemeClass>(classes[i]);
+            if ((lexemeClass == LexemeClass::VARIABLE && values[i] >= header.nameCount) ||
+                (lexemeClass == LexemeClass::VECTOR && values[i] >= header.vectorCount) ||
+                (isPooledConstant(previousClass, lexemeClass) && values[i] >= header.constantCount))
+                return false;
+            previousClass = lexemeClass;
+        }
+
+        return farIndex == header.farLineCount;
+    }
+}
+
+std::uint64_t TokenCache::hashSource(std::string_view source) {
+    // Восемь байт за шаг с перемешиванием умножением; длина входит в начальное значение
+    std::uint64_t hash = 0x9E3779B97F4A7C15ULL ^ source.size();
+    auto mix = [&hash](std::uint64_t word) {
+        hash = (hash ^ (word * 0xC2B2AE3D27D4EB4FULL)) * 0xFF51AFD7ED558CCDULL;
+        hash ^= hash >> 32;
+    };
+
+    std::size_t i = 0;
+    for (; i + 8 <= source.size(); i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, source.data() + i, sizeof word);
+        mix(word);
+    }
+
+    std::uint64_t tail = 0;
+    if (i < source.size())
+        std::memcpy(&tail, source.data() + i, source.size() - i);
+    mix(tail);
+
+    return hash;
+}
+
+std::string TokenCache::path(const std::string &directory, std::uint64_t sourceHash) {
+    static constexpr char digits[] = "0123456789abcdef";
+    std::string name(16, '0');
+    for (std::size_t i = 0; i < name.size(); ++i)
+        name[name.size() - 1 - i] = digits[(sourceHash >> (4 * i)) & 0xF];
+
+    return (std::filesystem::path(directory) / (name + ".tok")).string();
+}
+
+void TokenCache::save(const std::string &cachePath, std::string_view source, std::uint64_t sourceHash,
+                      const LexResult &result) {
+    const TokenStream &lexemes = result.lexemes;
+
+    std::vector<std::uint64_t> nameOffsets{0};
+    for (const std::string_view name: result.nameTable.all())
+        nameOffsets.push_back(nameOffsets.back() + name.size());
+
+    std::vector<std::uint64_t> vectorOffsets{0};
+    for (const std::vector<unsigned> &vector: result.vectors)
+        vectorOffsets.push_back(vectorOffsets.back() + vector.size());
+
+    std::vector<FarLine> farLines;
+    for (const auto &[index, line]: lexemes.farLineTable())
+        farLines.push_back({index, line});
+
+    Header header{};
+    header.magic = magic;
+    header.version = version;
+    header.byteOrder = byteOrderMark;
+    header.sourceHash = sourceHash;
+    header.sourceSize = source.size();
+    header.lexemeCount = lexemes.size();
+    header.farLineCount = farLines.size();
+    header.lastLine = lexemes.lastLineNumber();
+    header.constantCount = result.constantTable.size();
+    header.nameCount = result.nameTable.size();
+    header.nameBytes = nameOffsets.back();
+    header.vectorCount = result.vectors.size();
+    header.vectorElements = vectorOffsets.back();
+
+    Layout layout;
+    computeLayout(header, ~std::size_t{0}, layout);
+
+    // Запись во временный файл и переименование: чтение никогда не увидит половину файла,
+    // а одновременные запуски не пишут в один файл
+    const std::string temporaryPath = cachePath + '.' + std::to_string(getpid()) + ".tmp";
+    std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (!file)
+        throw std::runtime_error("Не удалось создать файл кэша: " + temporaryPath);
+
+    Writer writer(file);
+    writer.items(&header, 1);
+    writer.section(layout.classes);
+    writer.items(lexemes.classColumn().data(), lexemes.size());
+    writer.section(layout.values);
+    writer.items(lexemes.valueColumn().data(), lexemes.size());
+    writer.section(layout.lineDeltas);
+    writer.items(lexemes.lineDeltaColumn().data(), lexemes.size());
+    writer.section(layout.farLines);
+    writer.items(farLines.data(), farLines.size());
+    writer.section(layout.constants);
+    writer.items(result.constantTable.all().data(), result.constantTable.size());
+    writer.section(layout.nameOffsets);
+    writer.items(nameOffsets.data(), nameOffsets.size());
+    writer.section(layout.names);
+    for (const std::string_view name: result.nameTable.all())
+        writer.bytes(name.data(), name.size());
+    writer.section(layout.vectorOffsets);
+    writer.items(vectorOffsets.data(), vectorOffsets.size());
+    writer.section(layout.vectorElements);
+    for (const std::vector<unsigned> &vector: result.vectors)
+        writer.items(vector.data(), vector.size());
+
+    file.close();
+    if (!file)
+        throw std::runtime_error("Не удалось записать файл кэша: " + temporaryPath);
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, cachePath, error);
+    if (error) {
+        std::filesystem::remove(temporaryPath, error);
+        throw std::runtime_error("Не удалось переименовать файл кэша: " + cachePath);
+    }
+}
+
+std::optional<LexResult> TokenCache::load(const std::string &cachePath, std::string_view source,
+                                          std::uint64_t sourceHash) {
+    SourceBuffer buffer;
+    try {
+        buffer = SourceBuffer::map(cachePath);
+    } catch (const std::runtime_error &) {
+        return std::nullopt;
+    }
+
+    const std::string_view file = buffer.view();
+    if (file.size() < sizeof(Header))
+        return std::nullopt;
+
+    Header header;
+    std::memcpy(&header, file.data(), sizeof header);
+    Layout layout;
+    if (header.magic != magic || header.version != version || header.byteOrder != byteOrderMark ||
+        header.sourceHash != sourceHash || header.sourceSize != source.size() ||
+        !computeLayout(header, file.size(), layout))
+        return std::nullopt;
+
+    const char *base = file.data();
+    const auto lexemeCount = static_cast<std::size_t>(header.lexemeCount);
+
+    if (!validLexemes(header, base, layout))
+        return std::nullopt;
+
+    const FarLine *farLines = at<FarLine>(base, layout.farLines);
+    std::vector<std::pair<std::size_t, unsigned>> farLineTable;
+    farLineTable.reserve(static_cast<std::size_t>(header.farLineCount));
+    for (std::size_t i = 0; i < header.farLineCount; ++i)
+        farLineTable.emplace_back(farLines[i].index, static_cast<unsigned>(farLines[i].line));
+
+    LexResult result;
+    result.lexemes = TokenStream({at<std::uint16_t>(base, layout.classes), lexemeCount},
+                                 {at<std::uint32_t>(base, layout.values), lexemeCount},
+                                 {at<std::uint8_t>(base, layout.lineDeltas), lexemeCount}, std::move(farLineTable),
+                                 static_cast<unsigned>(header.lastLine));
+
+    const auto *constants = at<std::uint32_t>(base, layout.constants);
+    for (std::size_t i = 0; i < header.constantCount; ++i)
+        result.constantTable.intern(constants[i]);
+    if (result.constantTable.size() != header.constantCount)
+        return std::nullopt; // повторённая константа сдвинула бы индексы следующих
+
+    // Имена остаются в отображённом файле, таблица только ссылается на них
+    const auto *nameOffsets = at<std::uint64_t>(base, layout.nameOffsets);
+    for (std::size_t i = 0; i < header.nameCount; ++i) {
+        if (nameOffsets[i] > nameOffsets[i + 1] || nameOffsets[i + 1] > header.nameBytes)
+            return std::nullopt;
+
+        const std::string_view name(base + layout.names + nameOffsets[i],
+                                    static_cast<std::size_t>(nameOffsets[i + 1] - nameOffsets[i]));
+        result.nameTable.intern(name, true);
+    }
+    if (result.nameTable.size() != header.nameCount)
+        return std::nullopt; // повторённое имя сдвинуло бы номера следующих
+
+    const auto *vectorOffsets = at<std::uint64_t>(base, layout.vectorOffsets);
+    const auto *elements = at<std::uint32_t>(base, layout.vectorElements);
+    result.vectors.reserve(static_cast<std::size_t>(header.vectorCount));
+    for (std::size_t i = 0; i < header.vectorCount; ++i) {
+        if (vectorOffsets[i] > vectorOffsets[i + 1] || vectorOffsets[i + 1] > header.vectorElements)
+            return std::nullopt;
+
+        result.vectors.emplace_back(elements + vectorOffsets[i], elements + vectorOffsets[i + 1]);
+    }
+
+    result.source = std::make_shared<const SourceBuffer>(std::move(buffer));
+
+    return result;
+}
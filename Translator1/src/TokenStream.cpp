@@ -0,0 +1,143 @@
+#include <algorithm>
+
+#include "../include/TokenStream.hpp"
+
+TokenStream::TokenStream(std::span<const std::uint16_t> classes, std::span<const std::uint32_t> values,
+                         std::span<const std::uint8_t> lineDeltas,
+                         std::vector<std::pair<std::size_t, unsigned>> farLines, unsigned lastLine)
+    : classes(classes), values(values), lineDeltas(lineDeltas), farLines(std::move(farLines)), lastLine(lastLine) {}
+
+void TokenStream::push_back(const Lexeme &lexeme) {
+    classes.push_back(static_cast<std::uint16_t>(lexeme.lexemeClass));
+    values.push_back(lexeme.value);
+
+    // Строки лексем не убывают, поэтому прирост почти всегда равен 0 или 1
+    if (lexeme.lineNumber >= lastLine && lexeme.lineNumber - lastLine < farDelta)
+        lineDeltas.push_back(static_cast<std::uint8_t>(lexeme.lineNumber - lastLine));
+    else {
+        lineDeltas.push_back(farDelta);
+        farLines.emplace_back(classes.size() - 1, lexeme.lineNumber);
+    }
+
+    lastLine = lexeme.lineNumber;
+}
+
+void TokenStream::reserve(std::size_t count) {
+    classes.reserve(count);
+    values.reserve(count);
+    lineDeltas.reserve(count);
+}
+
+unsigned TokenStream::lineAt(std::size_t index) const {
+    // Отсчёт от ближайшей абсолютной строки не дальше index
+    auto far = std::upper_bound(farLines.begin(), farLines.end(), index,
+                                [](std::size_t position, const auto &entry) { return position < entry.first; });
+
+    std::size_t from = 0;
+    unsigned line = 0;
+    if (far != farLines.begin()) {
+        --far;
+        from = far->first + 1;
+        line = far->second;
+    }
+
+    for (std::size_t i = from; i <= index; ++i)
+        line += lineDeltas[i];
+
+    return line;
+}
+
+std::size_t TokenStream::lowerBound(unsigned line) const {
+    unsigned current = 0;
+    std::size_t farIndex = 0;
+    for (std::size_t i = 0; i < lineDeltas.size(); ++i) {
+        current = lineDeltas[i] == farDelta ? farLines[farIndex++].second : current + lineDeltas[i];
+        if (current >= line)
+            return i;
+    }
+
+    return size();
+}
+
+void TokenStream::replace(std::size_t first, std::size_t last, const TokenStream &replacement, std::int64_t lineShift) {
+    const bool hasTail = last < size();
+    const unsigned tailLine = hasTail ? static_cast<unsigned>(lineAt(last) + lineShift) : 0;
+
+    // Приросты замены и первой лексемы хвоста отсчитываются от лексемы перед first
+    std::vector<std::uint8_t> deltas;
+    std::vector<std::pair<std::size_t, unsigned>> far;
+    deltas.reserve(replacement.size() + 1);
+    unsigned line = first == 0 ? 0 : lineAt(first - 1);
+    std::size_t index = first;
+    auto encode = [&](unsigned lexemeLine) {
+        if (lexemeLine >= line && lexemeLine - line < farDelta)
+            deltas.push_back(static_cast<std::uint8_t>(lexemeLine - line));
+        else {
+            deltas.push_back(farDelta);
+            far.emplace_back(index, lexemeLine);
+        }
+
+        line = lexemeLine;
+        ++index;
+    };
+
+    for (const Lexeme lexeme: replacement)
+        encode(lexeme.lineNumber);
+    if (hasTail)
+        encode(tailLine);
+
+    // Абсолютные строки: до first без изменений, затем замена, затем сдвинутый хвост
+    std::vector<std::pair<std::size_t, unsigned>> merged;
+    merged.reserve(farLines.size() + far.size());
+    auto tail = farLines.begin();
+    for (; tail != farLines.end() && tail->first < first; ++tail)
+        merged.push_back(*tail);
+    merged.insert(merged.end(), far.begin(), far.end());
+    for (; tail != farLines.end(); ++tail)
+        if (tail->first > last)
+            merged.emplace_back(tail->first - last + first + replacement.size(),
+                                static_cast<unsigned>(tail->second + lineShift));
+    farLines = std::move(merged);
+
+    classes.splice(first, last, replacement.classes.begin(), replacement.classes.end());
+    values.splice(first, last, replacement.values.begin(), replacement.values.end());
+    lineDeltas.splice(first, last + (hasTail ? 1 : 0), deltas.data(), deltas.data() + deltas.size());
+
+    lastLine = hasTail ? static_cast<unsigned>(lastLine + lineShift) : line;
+}
+
+std::size_t TokenStream::memoryBytes() const {
+    return classes.ownedBytes() + values.ownedBytes() + lineDeltas.ownedBytes() +
+           farLines.capacity() * sizeof(farLines.front());
+}
+
+TokenStream::Iterator::Iterator(const TokenStream *stream, std::size_t index)
+    : stream(stream), index(index), line(0), farIndex(0) {
+    if (index == 0 && index < stream->size())
+        decodeLine();
+}
+
+void TokenStream::Iterator::decodeLine() {
+    if (stream->lineDeltas[index] == farDelta)
+        line = stream->farLines[farIndex++].second;
+    else
+        line += stream->lineDeltas[index];
+}
+
+Lexeme TokenStream::Iterator::operator*() const {
+    return {stream->lexemeClass(index), stream->values[index], line};
+}
+
+TokenStream::Iterator &TokenStream::Iterator::operator++() {
+    if (++index < stream->size())
+        decodeLine();
+
+    return *this;
+}
+
+TokenStream::Iterator TokenStream::Iterator::operator++(int) {
+    Iterator previous = *this;
+    ++*this;
+
+    return previous;
+}
@@ -0,0 +1,33 @@
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/ValueHeap.hpp"
+
+Value ValueHeap::make(BigNat number) {
+    if (number.isSmall() && number.smallValue() <= Value::maxInline)
+        return Value::number(number.smallValue());
+
+    return Value::object(Value::Kind::NUMBER, numbers.allocate(std::move(number)));
+}
+
+void ValueHeap::throwKind(Value::Kind expected) {
+    switch (expected) {
+        case Value::Kind::VECTOR: throw std::runtime_error("Ожидался вектор");
+        case Value::Kind::MATRIX: throw std::runtime_error("Ожидалась матрица");
+        default: throw std::runtime_error("Ожидалось число");
+    }
+}
+
+void ValueHeap::print(std::ostream &os, Value value) const {
+    if (value.isInline()) {
+        os << BigNat(value.inlineNumber());
+        return;
+    }
+
+    switch (value.kind()) {
+        case Value::Kind::NUMBER: os << numbers[value.handle()]; break;
+        case Value::Kind::VECTOR: os << vectors[value.handle()]; break;
+        case Value::Kind::MATRIX: os << matrices[value.handle()]; break;
+        case Value::Kind::EMPTY: break;
+    }
+}
@@ -0,0 +1,322 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Interpreter.hpp"
+
+// Скорость выполнения циклов при разных способах выбора обработчика инструкции.
+// Перед замерами примеры и программы на границах окон оптимизатора выполняются с оптимизатором и без него,
+// а примеры ещё и загружаются обоими загрузчиками: по LexResult и одновременно с лексическим анализом;
+// при расхождении вывода, сообщений об ошибках или байт-кода бенчмарк завершается с ошибкой.
+// С -c выполняется только проверка.
+// Запуск: interpreter_benchmark [-n итерации] [-r повторы] [-c] [каталог примеров]
+namespace {
+    struct Options {
+        unsigned iterations = 1000000;
+        unsigned repeats = 3;
+        bool checkOnly = false;
+        std::filesystem::path corpus = RGR4_EXAMPLES_DIR;
+    };
+
+    struct Workload {
+        std::string_view name;
+        std::vector<std::string> program;
+    };
+
+    // Простое число не меньше value: цикл проверки простоты проходит все делители
+    unsigned nextPrime(unsigned value) {
+        auto isPrime = [](unsigned n) {
+            for (unsigned d = 2; d * d <= n; ++d)
+                if (n % d == 0)
+                    return false;
+            return n >= 2;
+        };
+
+        while (!isPrime(value))
+            ++value;
+
+        return value;
+    }
+
+    // Проверка простоты делением, как в examples/input4, но без ввода и вывода
+    std::vector<std::string> primeProgram(unsigned iterations) {
+        return {
+            "push " + std::to_string(nextPrime(iterations)), "pop x", "push 2", "pop y",
+            "push y", "push x", ">=", "ji 21",
+            "push x", "push y", "%", "push 0", "=", "ji 21",
+            "push y", "push 1", "+", "pop y", "jmp 5", "",
+            "end"
+        };
+    }
+
+    std::vector<std::string> countdownProgram(unsigned iterations) {
+        return {
+            "push " + std::to_string(iterations), "pop n",
+            "push n", "push 1", "-", "pop n",
+            "push n", "push 0", ">", "ji 3",
+            "end"
+        };
+    }
+
+    // Сумма остатков i * i % 7: умножение, деление и сложение на каждой итерации
+    std::vector<std::string> arithmeticProgram(unsigned iterations) {
+        return {
+            "push 0", "pop s", "push 0", "pop i",
+            "push s", "push i", "push i", "*", "push 7", "%", "+", "pop s",
+            "push i", "push 1", "+", "pop i",
+            "push i", "push " + std::to_string(iterations), "<", "ji 5",
+            "end"
+        };
+    }
+
+    // Программы, на которых оптимизатор может изменить поведение
+    const Workload checkedPrograms[] = {
+        // Деление на ноль не сворачивается: ошибка сообщается при выполнении строки 3
+        {"fold_division_by_zero", {"push 7", "push 0", "/", "write", "end"}},
+        // Уменьшение нуля через dec y сообщает ту же ошибку, что и вычитание
+        {"decrement_below_zero", {"push 0", "pop y", "push y", "push 1", "-", "pop y", "push y", "write", "end"}},
+        // Переход на push 1 внутри окна push x / push 1 / + / pop x: окно не сливается
+        {"jump_into_fusion", {
+            "push 0", "pop x", "push x", "push 1", "+", "pop x", "push x", "write",
+            "push x", "push x", "push 5", "<", "ji 4", "end"
+        }}
+    };
+
+    constexpr std::string_view checkInput = "7\n7\n7\n"; // ответы на read в примерах
+    constexpr std::size_t outputLimit = std::size_t{1} << 16;
+
+    // Вывод с пределом: бесконечный цикл (examples/input6) прерывается исключением, которое интерпретатор
+    // сообщает как ошибку выполнения, поэтому его вывод тоже сравнивается
+    class LimitedOutput : public std::streambuf {
+        std::string text;
+
+    public:
+        [[nodiscard]] const std::string &str() const { return text; }
+
+    protected:
+        int_type overflow(int_type ch) override {
+            if (traits_type::eq_int_type(ch, traits_type::eof()))
+                return traits_type::not_eof(ch);
+
+            const char symbol = traits_type::to_char_type(ch);
+            xsputn(&symbol, 1);
+
+            return ch;
+        }
+
+        std::streamsize xsputn(const char *data, std::streamsize count) override {
+            if (text.size() + static_cast<std::size_t>(count) > outputLimit)
+                throw std::length_error("вывод превысил предел проверки");
+
+            text.append(data, static_cast<std::size_t>(count));
+
+            return count;
+        }
+    };
+
+    struct Run {
+        std::string output;
+        std::string errors;
+
+        bool operator==(const Run &other) const = default;
+    };
+
+    // Выполнение action с подменёнными стандартными потоками
+    template<typename Action>
+    Run captured(Action action) {
+        std::istringstream input{std::string(checkInput)};
+        LimitedOutput output;
+        std::ostringstream errors;
+        std::streambuf *const savedInput = std::cin.rdbuf(input.rdbuf());
+        std::streambuf *const savedOutput = std::cout.rdbuf(&output);
+        std::streambuf *const savedErrors = std::cerr.rdbuf(errors.rdbuf());
+        std::cout.exceptions(std::ios::badbit); // иначе поток проглотит исключение буфера
+        // Сообщение об ошибке не сбрасывает испорченный std::cout, иначе вместо него выйдет ошибка потока
+        std::ostream *const savedTie = std::cerr.tie(nullptr);
+
+        try {
+            action();
+        } catch (const std::exception &e) {
+            errors << e.what() << '\n';
+        }
+
+        std::cout.exceptions(std::ios::goodbit);
+        std::cout.clear();
+        std::cin.clear();
+        std::cin.rdbuf(savedInput);
+        std::cout.rdbuf(savedOutput);
+        std::cerr.rdbuf(savedErrors);
+        std::cerr.tie(savedTie);
+
+        return {output.str(), errors.str()};
+    }
+
+    // lexResult == nullptr — программа без векторов
+    Run run(const std::vector<std::string> &program, const LexResult *lexResult, bool optimize) {
+        return captured([&] {
+            Interpreter interpreter = lexResult ? Interpreter(program, *lexResult) : Interpreter(program);
+            interpreter.execute(Interpreter::defaultDispatch, optimize);
+        });
+    }
+
+    bool checkOptimizer(std::string_view name, const std::vector<std::string> &program, const LexResult *lexResult) {
+        const Run plain = run(program, lexResult, false);
+        const Run optimized = run(program, lexResult, true);
+        std::cout << "  " << std::left << std::setw(24) << name << std::right
+                  << (plain == optimized ? "совпадает" : "не совпадает") << '\n';
+        if (plain == optimized)
+            return true;
+
+        std::cerr << name << " без оптимизатора:\n" << plain.output << plain.errors
+                  << name << " с оптимизатором:\n" << optimized.output << optimized.errors << std::flush;
+
+        return false;
+    }
+
+    // Оба загрузчика дают одинаковый байт-код до оптимизации и одинаковый вывод
+    bool checkStreamingLoader(const std::filesystem::path &file, const std::vector<std::string> &program,
+                              const LexResult &lexResult) {
+        std::ifstream input(file, std::ios::binary);
+        const std::string text{std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+
+        Bytecode loaded;
+        Bytecode streamed;
+        const Run fromResult = captured([&] {
+            Interpreter interpreter(program, lexResult);
+            interpreter.execute(Interpreter::defaultDispatch, false);
+            loaded = interpreter.getBytecode();
+        });
+        const Run fromLexer = captured([&] {
+            Lexer lexer;
+            lexer.start(text);
+            Interpreter interpreter(program, lexer);
+            interpreter.execute(Interpreter::defaultDispatch, false);
+            streamed = interpreter.getBytecode();
+        });
+
+        if (loaded == streamed && fromResult == fromLexer)
+            return true;
+
+        std::cerr << file.filename().string() << ": загрузка одновременно с лексическим анализом расходится "
+                  << "с загрузкой по LexResult" << std::endl;
+
+        return false;
+    }
+
+    bool checkPrograms(const Options &options) {
+        if (!std::filesystem::is_directory(options.corpus)) {
+            std::cerr << "Каталог примеров не найден: " << options.corpus << std::endl;
+            return false;
+        }
+
+        std::vector<std::filesystem::path> files;
+        for (const auto &entry: std::filesystem::directory_iterator(options.corpus))
+            if (entry.is_regular_file())
+                files.push_back(entry.path());
+        std::ranges::sort(files);
+
+        std::cout << "вывод с оптимизатором и без него:\n";
+        bool success = true;
+        for (const auto &file: files) {
+            try {
+                const LexResult lexResult = parse(file.string());
+                const std::vector<std::string> program = Interpreter::readFileIntoVector(file.string());
+                success = checkOptimizer(file.filename().string(), program, &lexResult) && success;
+                success = checkStreamingLoader(file, program, lexResult) && success;
+            } catch (const std::exception &e) {
+                std::cerr << "Ошибка при разборе " << file << ": " << e.what() << std::endl;
+                success = false;
+            }
+        }
+
+        for (const Workload &workload: checkedPrograms)
+            success = checkOptimizer(workload.name, workload.program, nullptr) && success;
+        std::cout << std::flush;
+
+        return success;
+    }
+
+    double measure(const std::vector<std::string> &program, Interpreter::Dispatch dispatch, unsigned repeats) {
+        double best = 1e300;
+        for (unsigned i = 0; i < repeats; ++i) {
+            Interpreter interpreter(program);
+            const auto start = std::chrono::steady_clock::now();
+            interpreter.execute(dispatch);
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::min(best, elapsed.count());
+        }
+
+        return best;
+    }
+
+    bool parseOptions(int argc, char **argv, Options &options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view argument = argv[i];
+            const bool hasValue = i + 1 < argc;
+
+            if (argument == "-n" && hasValue)
+                options.iterations = static_cast<unsigned>(std::stoul(argv[++i]));
+            else if (argument == "-r" && hasValue)
+                options.repeats = static_cast<unsigned>(std::stoul(argv[++i]));
+            else if (argument == "-c")
+                options.checkOnly = true;
+            else if (!argument.starts_with('-'))
+                options.corpus = argument;
+            else {
+                std::cerr << "Использование: " << argv[0] << " [-n итерации] [-r повторы] [-c] [каталог примеров]"
+                          << std::endl;
+                return false;
+            }
+        }
+
+        return options.iterations > 0 && options.repeats > 0;
+    }
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    try {
+        if (!parseOptions(argc, argv, options))
+            return EXIT_FAILURE;
+    } catch (const std::exception &) {
+        std::cerr << "Некорректное числовое значение параметра" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (!checkPrograms(options))
+        return EXIT_FAILURE;
+    if (options.checkOnly)
+        return EXIT_SUCCESS;
+
+#if !RGR4_COMPUTED_GOTO
+    std::cout << "Вычисляемый goto недоступен, оба замера выполняются через switch\n";
+#endif
+
+    const Workload workloads[] = {
+        {"prime", primeProgram(options.iterations)},
+        {"countdown", countdownProgram(options.iterations)},
+        {"arithmetic", arithmeticProgram(options.iterations)}
+    };
+
+    for (const Workload &workload: workloads) {
+        const double switchSeconds = measure(workload.program, Interpreter::Dispatch::SWITCH, options.repeats);
+        const double threadedSeconds = measure(workload.program, Interpreter::Dispatch::THREADED, options.repeats);
+
+        std::cout << std::left << std::setw(12) << workload.name << std::right << std::fixed << std::setprecision(3)
+                  << "switch " << std::setw(8) << switchSeconds << " с   threaded " << std::setw(8)
+                  << threadedSeconds << " с   ускорение " << std::setprecision(2)
+                  << switchSeconds / threadedSeconds << "x\n";
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,376 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "IncrementalLexer.hpp"
+#include "LexicalAnalyzer.hpp"
+
+// Пропускная способность лексического анализатора на сгенерированных программах.
+// Перед замерами проверяется, что параллельный разбор даёт тот же результат, что и последовательный,
+// а разбор после случайных правок IncrementalLexer — тот же, что и разбор всего текста заново;
+// при расхождении бенчмарк завершается с ошибкой. С -c выполняется только проверка.
+// Запуск: lexer_benchmark [-s мегабайты] [-r повторы] [-m смесь] [-e правки] [-c] [каталог примеров]
+namespace {
+    enum class Mix { keywords, comments, vectors, names, mixed };
+
+    struct MixInfo {
+        Mix mix;
+        std::string_view name;
+    };
+
+    constexpr MixInfo mixes[] = {
+        {Mix::keywords, "keywords"},
+        {Mix::comments, "comments"},
+        {Mix::vectors, "vectors"},
+        {Mix::names, "names"},
+        {Mix::mixed, "mixed"}
+    };
+
+    constexpr std::string_view commands[] = {
+        "push x", "push 12", "pop y", "+", "-", "*", "/", "%", "<=", "!=", "==", "jmp 5", "ji 3", "read", "write",
+        "end", "vadd", "vdot", "vsort", "vfind", "mload", "mmul", "vget", "vset"
+    };
+
+    struct Options {
+        std::size_t megabytes = 32;
+        unsigned repeats = 3;
+        std::string_view onlyMix;
+        unsigned edits = 3000; // случайных правок в проверке IncrementalLexer
+        bool checkOnly = false;
+        std::filesystem::path corpus = RGR4_EXAMPLES_DIR;
+    };
+
+    struct Measurement {
+        std::size_t lexemes = 0;
+        double seconds = 0;
+    };
+
+    void appendKeywordLine(std::string &text, std::mt19937 &random) {
+        text += commands[random() % std::size(commands)];
+        text += '\n';
+    }
+
+    void appendCommentLine(std::string &text, std::mt19937 &random) {
+        if (random() % 4 == 0) {
+            appendKeywordLine(text, random);
+            return;
+        }
+
+        text += random() % 2 ? "; комментарий к вычислению, который анализатор пропускает целиком\n"
+                             : "push 1 ; комментарий после команды\n";
+    }
+
+    void appendVectorLine(std::string &text, std::mt19937 &random) {
+        text += "push <<";
+        for (unsigned i = 0; i < 1000; ++i) {
+            if (i != 0)
+                text += ", ";
+            text += std::to_string(random() % 1000000000);
+        }
+        text += ">>\npop v\n";
+    }
+
+    void appendNameLine(std::string &text, std::mt19937 &random) {
+        text += random() % 2 ? "push v" : "pop w";
+        text += std::to_string(random() % 1000000);
+        text += '\n';
+    }
+
+    std::string generateProgram(Mix mix, std::size_t bytes, unsigned seed) {
+        std::mt19937 random(seed);
+        std::string text;
+        text.reserve(bytes + 16384);
+
+        while (text.size() < bytes) {
+            // В смешанной программе длинные векторы редки, иначе они занимали бы почти весь текст
+            Mix line = mix;
+            if (mix == Mix::mixed) {
+                constexpr Mix shortLines[] = {Mix::keywords, Mix::comments, Mix::names};
+                line = random() % 100 == 0 ? Mix::vectors : shortLines[random() % std::size(shortLines)];
+            }
+
+            switch (line) {
+                case Mix::keywords:
+                    appendKeywordLine(text, random);
+                    break;
+                case Mix::comments:
+                    appendCommentLine(text, random);
+                    break;
+                case Mix::vectors:
+                    appendVectorLine(text, random);
+                    break;
+                case Mix::names:
+                case Mix::mixed:
+                    appendNameLine(text, random);
+                    break;
+            }
+        }
+
+        return text;
+    }
+
+    template<typename Parse>
+    Measurement measure(unsigned repeats, Parse parse) {
+        Measurement best{0, 1e300};
+        for (unsigned i = 0; i < repeats; ++i) {
+            const auto start = std::chrono::steady_clock::now();
+            const LexResult result = parse();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+            best.lexemes = result.lexemes.size();
+            best.seconds = std::min(best.seconds, elapsed.count());
+        }
+
+        return best;
+    }
+
+    bool sameResult(const LexResult &serial, const LexResult &parallel) {
+        if (serial.lexemes.size() != parallel.lexemes.size())
+            return false;
+
+        for (auto a = serial.lexemes.begin(), b = parallel.lexemes.begin(); a != serial.lexemes.end(); ++a, ++b) {
+            const Lexeme left = *a;
+            const Lexeme right = *b;
+            if (left.lexemeClass != right.lexemeClass || left.value != right.value ||
+                left.lineNumber != right.lineNumber)
+                return false;
+        }
+
+        return serial.constantTable.all() == parallel.constantTable.all() &&
+               serial.nameTable.all() == parallel.nameTable.all() && serial.vectors == parallel.vectors &&
+               serial.diagnostics == parallel.diagnostics;
+    }
+
+    // Параллельный разбор при разном числе потоков сравнивается с последовательным: лексемы, константы,
+    // имена, векторы и сообщения об ошибках. Текст должен быть не короче Lexer::parallelThreshold,
+    // иначе потоки не запускаются
+    bool checkParallel(std::string_view name, std::string_view text) {
+        const LexResult serial = Lexer{}.parse(text);
+        std::vector<unsigned> mismatched;
+        for (const unsigned threads: {2U, 3U, 0U})
+            if (!sameResult(serial, Lexer::parseParallel(text, threads)))
+                mismatched.push_back(threads);
+
+        for (const unsigned threads: mismatched)
+            std::cerr << name << ": параллельный разбор (" << (threads == 0 ? "все ядра" : std::to_string(threads))
+                      << ") расходится с последовательным" << std::endl;
+
+        return mismatched.empty();
+    }
+
+    // Строки для правок: команды, векторы, комментарии и строки с лексическими ошибками
+    constexpr std::string_view editLines[] = {
+        "push x", "push 12", "pop y", "+", "<=", "!=", "jmp 5", "ji 3", "read", "write", "end", "vadd", "vget",
+        "push <<1, 2, 3>>", "push <<4, 5", "; комментарий", "push 7 ; комментарий", "", "push v12", "pop w3",
+        "push 99999999999", "pushh x", "pop 6", "pop end", "$"
+    };
+
+    std::string randomLines(std::mt19937 &random, unsigned count) {
+        std::string text;
+        for (unsigned i = 0; i < count; ++i) {
+            text += editLines[random() % std::size(editLines)];
+            text += '\n';
+        }
+
+        return text;
+    }
+
+    // Лексемы со значениями, разрешёнными через таблицы: IncrementalLexer хранит в таблицах и имена,
+    // которых в тексте больше нет, поэтому номера в них могут не совпадать с номерами свежего разбора
+    std::vector<std::string> describeLexemes(const LexResult &result) {
+        std::vector<std::string> described;
+        LexemeClass previousClass{};
+        for (const Lexeme lexeme: result.lexemes) {
+            described.push_back(std::to_string(static_cast<int>(lexeme.lexemeClass)) + ' ' +
+                                std::to_string(lexeme.lineNumber) + ' ' +
+                                getLexemeValueString(result, lexeme.lexemeClass, lexeme.value, previousClass));
+            previousClass = lexeme.lexemeClass;
+        }
+
+        return described;
+    }
+
+    // Случайные правки текста; после каждой результат сравнивается с разбором всего текста
+    bool checkIncremental(unsigned edits) {
+        std::mt19937 random(47);
+        IncrementalLexer incremental(randomLines(random, 200));
+
+        for (unsigned edit = 0; edit < edits; ++edit) {
+            const unsigned lines = incremental.lineCount();
+            const auto firstLine = static_cast<unsigned>(random() % (lines + 1) + 1);
+            const auto lineCount = std::min(static_cast<unsigned>(random() % 4), lines + 1 - firstLine);
+            std::string newLines = randomLines(random, static_cast<unsigned>(random() % 4));
+            if (random() % 2 && !newLines.empty())
+                newLines.pop_back();
+
+            incremental.edit(firstLine, lineCount, newLines);
+
+            const LexResult fresh = Lexer{}.parse(incremental.source());
+            const LexResult &result = incremental.result();
+            if (describeLexemes(fresh) != describeLexemes(result) || fresh.diagnostics != result.diagnostics) {
+                std::cerr << "IncrementalLexer: правка " << edit + 1 << " (строки " << firstLine << '+' << lineCount
+                          << ") расходится с разбором всего текста" << std::endl;
+                return false;
+            }
+        }
+
+        std::cout << "IncrementalLexer: " << edits << " правок совпадают с разбором всего текста\n";
+
+        return true;
+    }
+
+    double peakResidentMegabytes() {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+
+        return static_cast<double>(usage.ru_maxrss) / 1024.0; // ru_maxrss в килобайтах
+    }
+
+    void printMeasurement(std::string_view mode, std::size_t bytes, const Measurement &measurement) {
+        std::cout << "  " << std::left << std::setw(12) << mode << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << static_cast<double>(bytes) / measurement.seconds / 1e6 << " МБ/с"
+                  << std::setw(10) << static_cast<double>(measurement.lexemes) / measurement.seconds / 1e6
+                  << " млн лексем/с" << std::setw(12) << measurement.lexemes << " лексем\n";
+    }
+
+    // Каждая смесь разбирается в отдельном процессе, чтобы пик памяти относился только к ней
+    bool runMix(const MixInfo &info, const Options &options) {
+        std::cout.flush();
+        const pid_t child = fork();
+        if (child < 0) {
+            std::cerr << "Не удалось запустить процесс для смеси " << info.name << std::endl;
+            return false;
+        }
+
+        if (child == 0) {
+            const std::string text = generateProgram(info.mix, options.megabytes << 20, 47);
+            std::cout << info.name << ": " << text.size() / (1 << 20) << " МБ\n";
+
+            if (text.size() < Lexer::parallelThreshold)
+                std::cout << "  меньше порога параллельного разбора, сравнение не проверяет части\n";
+            const bool matches = checkParallel(info.name, text);
+            std::cout << "  параллельный разбор " << (matches ? "совпадает" : "не совпадает")
+                      << " с последовательным" << std::endl;
+            if (!matches || options.checkOnly)
+                std::_Exit(matches ? EXIT_SUCCESS : EXIT_FAILURE);
+
+            printMeasurement("serial", text.size(), measure(options.repeats, [&] { return Lexer{}.parse(text); }));
+            printMeasurement("parallel", text.size(),
+                             measure(options.repeats, [&] { return Lexer::parseParallel(text); }));
+            std::cout << "  пик памяти: " << std::setprecision(1) << peakResidentMegabytes() << " МБ" << std::endl;
+
+            std::_Exit(EXIT_SUCCESS);
+        }
+
+        int status = 0;
+        waitpid(child, &status, 0);
+
+        return WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+    }
+
+    // Пример, повторённый до размера, при котором parseParallel действительно делит текст на части
+    bool checkCorpusFile(const std::filesystem::path &file) {
+        std::ifstream input(file, std::ios::binary);
+        const std::string program{std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+        if (program.empty())
+            return true;
+
+        std::string text;
+        while (text.size() <= Lexer::parallelThreshold) {
+            text += program;
+            if (!program.ends_with('\n'))
+                text += '\n';
+        }
+
+        return checkParallel(file.filename().string(), text);
+    }
+
+    // Примеры из репозитория: проверка, что все они разбираются и что параллельный разбор совпадает
+    // с последовательным, и грубая оценка на маленьких текстах
+    bool runCorpus(const Options &options) {
+        if (!std::filesystem::is_directory(options.corpus)) {
+            std::cerr << "Каталог примеров не найден: " << options.corpus << std::endl;
+            return false;
+        }
+
+        std::vector<std::filesystem::path> files;
+        for (const auto &entry: std::filesystem::directory_iterator(options.corpus))
+            if (entry.is_regular_file())
+                files.push_back(entry.path());
+        std::ranges::sort(files);
+
+        std::cout << "examples (" << options.corpus.string() << "):\n";
+        for (const auto &file: files) {
+            try {
+                const LexResult result = parse(file.string());
+                std::cout << "  " << std::left << std::setw(12) << file.filename().string() << std::right
+                          << std::setw(8) << result.lexemes.size() << " лексем\n";
+                if (!checkCorpusFile(file))
+                    return false;
+            } catch (const std::exception &e) {
+                std::cerr << "Ошибка при разборе " << file << ": " << e.what() << std::endl;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool parseOptions(int argc, char **argv, Options &options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view argument = argv[i];
+            const bool hasValue = i + 1 < argc;
+
+            if (argument == "-s" && hasValue)
+                options.megabytes = std::stoul(argv[++i]);
+            else if (argument == "-r" && hasValue)
+                options.repeats = static_cast<unsigned>(std::stoul(argv[++i]));
+            else if (argument == "-m" && hasValue)
+                options.onlyMix = argv[++i];
+            else if (argument == "-e" && hasValue)
+                options.edits = static_cast<unsigned>(std::stoul(argv[++i]));
+            else if (argument == "-c")
+                options.checkOnly = true;
+            else if (!argument.starts_with('-'))
+                options.corpus = argument;
+            else {
+                std::cerr << "Использование: " << argv[0]
+                          << " [-s мегабайты] [-r повторы] [-m смесь] [-e правки] [-c] [каталог примеров]"
+                          << std::endl;
+                return false;
+            }
+        }
+
+        return options.megabytes > 0 && options.repeats > 0;
+    }
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    try {
+        if (!parseOptions(argc, argv, options))
+            return EXIT_FAILURE;
+    } catch (const std::exception &) {
+        std::cerr << "Некорректное числовое значение параметра" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    bool success = runCorpus(options) && checkIncremental(options.edits);
+    for (const MixInfo &info: mixes)
+        if (options.onlyMix.empty() || options.onlyMix == info.name)
+            success = runMix(info, options) && success;
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
 
 #include "Translator1/include/LexicalAnalyzer.hpp"
@@ -15,22 +19,58 @@ int main() {
 
     checkFile.close();
 
+    // Бюджет памяти для векторов в мегабайтах
+    if (const char *budget = std::getenv("RGR4_MEMORY_BUDGET_MB")) {
+        // Только цифры: stoull пропускает пробелы и переводит "-1" в ULLONG_MAX, а сдвиг на 20 бит
+        // молча обрезал бы слишком большое значение
+        const std::string_view text = budget;
+        bool valid = !text.empty() && std::ranges::all_of(text, [](char ch) { return ch >= '0' && ch <= '9'; });
+        unsigned long long megabytes = 0;
+        if (valid) {
+            try {
+                megabytes = std::stoull(std::string(text));
+                valid = megabytes <= (SIZE_MAX >> 20);
+            } catch (const std::out_of_range &) {
+                valid = false;
+            }
+        }
+
+        if (!valid) {
+            std::cerr << "Некорректное значение RGR4_MEMORY_BUDGET_MB: " << budget << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        Interpreter::setMemoryBudget(static_cast<std::size_t>(megabytes) << 20);
+    }
+
+    // Каталог кэша лексем: неизменённая программа повторно не разбирается
+    const char *cacheDirectory = std::getenv("RGR4_TOKEN_CACHE_DIR");
+
     std::vector<std::string> program = Interpreter::readFileIntoVector(filePath);
 
+    LexResult lexResult;
     try {
-        parse(filePath);
+        lexResult = parse(filePath, cacheDirectory ? cacheDirectory : "");
     } catch (const std::exception &e) {
         std::cerr << "Ошибка при лексическом анализе: " << e.what() << std::endl;
 
         return EXIT_FAILURE;
     }
 
+    for (const Diagnostic &diagnostic: lexResult.diagnostics)
+        std::cerr << diagnostic.text() << std::endl;
+
+    const auto &[lexemes, constantTable, nameTable, vectors, diagnostics, source] = lexResult;
+
     std::cout << "\nРезультаты лексического анализа:\n";
     std::cout << "Найдено лексем: " << lexemes.size() << '\n';
+    LexemeClass previousClass{};
     for (const auto &[lexemeClass, value, lineNumber]: lexemes) {
         std::cout << "Класс лексемы: " << static_cast<int>(lexemeClass)
-                << ", значение: " << getLexemeValueString(lexemeClass, value)
+                << ", значение: " << getLexemeValueString(lexResult, lexemeClass, value, previousClass)
                 << ", строка: " << lineNumber << '\n';
+        previousClass = lexemeClass;
     }
 
     std::cout << std::endl << "Таблица констант:\n";
@@ -38,7 +78,9 @@ int main() {
         std::cout << "Константы не найдены" << std::endl;
     else {
         std::cout << "Найдено констант: " << constantTable.size() << '\n';
-        for (const auto &value: constantTable)
+        std::vector<unsigned> values = constantTable.all();
+        std::ranges::sort(values);
+        for (const auto &value: values)
             std::cout << "Значение: " << value << '\n';
     }
 
@@ -47,7 +89,9 @@ int main() {
         std::cout << "Имена не найдены" << std::endl;
     else {
         std::cout << "Найдено имен: " << nameTable.size() << '\n';
-        for (const auto &name: nameTable | std::views::keys)
+        std::vector<std::string_view> names = nameTable.all();
+        std::ranges::sort(names);
+        for (const auto &name: names)
             std::cout << "Имя: " << name << '\n';
     }
 
@@ -69,7 +113,7 @@ int main() {
 
     try {
         std::cout << std::endl << "Запуск программы:\n";
-        Interpreter interpreter(program, vectors);
+        Interpreter interpreter(program, lexResult);
         interpreter.execute();
 
         std::cout << "\nСостояние после выполнения:\n";